@@ -0,0 +1,55 @@
+/**
+ * @file   database.cpp
+ */
+
+#include "database.h"
+
+#include <sqlite-burrito/statement.h>
+
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace bench {
+
+std::string database_path(database_kind kind) {
+   if (kind == database_kind::memory) {
+      return ":memory:";
+   }
+
+   const auto path = fs::temp_directory_path() / "sqlite-burrito-bench.db";
+   for (auto suffix : {"", "-wal", "-shm", "-journal"}) {
+      std::error_code ec;
+      fs::remove(path.string() + suffix, ec);
+   }
+   return path.string();
+}
+
+void open_database(sqlite_burrito::connection &con, database_kind kind) {
+   using namespace sqlite_burrito;
+
+   con.open(database_path(kind));
+   if (kind == database_kind::wal) {
+      statement::execute(con, "PRAGMA journal_mode = WAL;");
+      statement::execute(con, "PRAGMA synchronous = NORMAL;");
+   }
+
+   statement::execute(con,
+                      "CREATE TABLE test(id INTEGER PRIMARY KEY, int_value INTEGER, real_value REAL, "
+                      "text_value TEXT, blob_value BLOB);");
+   statement::execute(con,
+                      "INSERT INTO test(id, int_value, real_value, text_value, blob_value) "
+                      "VALUES (1, 1234567, 3.25, 'a short text value', x'000102030405060708090a0b0c0d0e0f');");
+}
+
+void database_kinds(benchmark::internal::Benchmark *bench) {
+   bench->ArgName("db");
+   bench->Arg(static_cast<int>(database_kind::memory));
+   bench->Arg(static_cast<int>(database_kind::wal));
+}
+
+void set_label(benchmark::State &state) {
+   state.SetLabel(static_cast<database_kind>(state.range(0)) == database_kind::memory ? "memory" : "wal");
+}
+
+} // namespace bench
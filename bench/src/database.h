@@ -0,0 +1,38 @@
+/**
+ * @file   database.h
+ */
+#ifndef BENCH_SRC_DATABASE_H
+#define BENCH_SRC_DATABASE_H
+
+#include <sqlite-burrito/connection.h>
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+namespace bench {
+
+//! Database kinds, all benchmarks are executed against each of them (passed as the first benchmark argument)
+enum class database_kind : int {
+   //! In-memory database
+   memory = 0,
+
+   //! On-disk database in the WAL journal mode
+   wal = 1,
+};
+
+//! @return Database path for the benchmark, on-disk databases are removed, so that each run starts from scratch
+std::string database_path(database_kind kind);
+
+//! Open a benchmark database, and create a test table with a single row in it
+void open_database(sqlite_burrito::connection &con, database_kind kind);
+
+//! Register each database kind as the first benchmark argument
+void database_kinds(benchmark::internal::Benchmark *bench);
+
+//! Label a benchmark with the database kind
+void set_label(benchmark::State &state);
+
+} // namespace bench
+
+#endif // BENCH_SRC_DATABASE_H
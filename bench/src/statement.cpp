@@ -0,0 +1,181 @@
+/**
+ * @file   statement.cpp
+ */
+
+#include "database.h"
+
+#include <sqlite-burrito/statement.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace sqlite_burrito;
+
+namespace {
+
+void bm_prepare(benchmark::State &state) {
+   connection con;
+   bench::open_database(con, static_cast<bench::database_kind>(state.range(0)));
+   bench::set_label(state);
+
+   statement stmt{con};
+   for (auto _ : state) {
+      stmt.prepare("SELECT int_value, real_value, text_value FROM test WHERE id = :pid;");
+   }
+}
+BENCHMARK(bm_prepare)->Apply(bench::database_kinds);
+
+void bm_bind_by_index(benchmark::State &state) {
+   connection con;
+   bench::open_database(con, static_cast<bench::database_kind>(state.range(0)));
+   bench::set_label(state);
+
+   statement stmt{con};
+   stmt.prepare("SELECT int_value FROM test WHERE id = :pid;");
+   for (auto _ : state) {
+      stmt.bind(1, 1);
+   }
+}
+BENCHMARK(bm_bind_by_index)->Apply(bench::database_kinds);
+
+void bm_bind_by_name(benchmark::State &state) {
+   connection con;
+   bench::open_database(con, static_cast<bench::database_kind>(state.range(0)));
+   bench::set_label(state);
+
+   statement stmt{con};
+   stmt.prepare("SELECT int_value FROM test WHERE id = :pid;");
+   for (auto _ : state) {
+      stmt.bind(":pid", 1);
+   }
+}
+BENCHMARK(bm_bind_by_name)->Apply(bench::database_kinds);
+
+//! Column index for each value type in the test table
+template <typename T>
+constexpr int column_for() {
+   if constexpr (std::is_floating_point_v<T>) {
+      return 1;
+   } else if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, text_view>) {
+      return 2;
+   } else if constexpr (std::is_same_v<T, std::vector<std::uint8_t>> || std::is_same_v<T, blob_view>) {
+      return 3;
+   } else {
+      return 0;
+   }
+}
+
+template <typename T>
+void bm_get(benchmark::State &state) {
+   connection con;
+   bench::open_database(con, static_cast<bench::database_kind>(state.range(0)));
+   bench::set_label(state);
+
+   statement stmt{con};
+   stmt.prepare("SELECT int_value, real_value, text_value, blob_value FROM test WHERE id = 1;");
+   stmt.step();
+
+   constexpr auto column = column_for<T>();
+   std::error_code ec;
+   T value{};
+   for (auto _ : state) {
+      stmt.get(column, value, ec);
+      benchmark::DoNotOptimize(value);
+   }
+}
+BENCHMARK_TEMPLATE(bm_get, bool)->Apply(bench::database_kinds);
+BENCHMARK_TEMPLATE(bm_get, std::int32_t)->Apply(bench::database_kinds);
+BENCHMARK_TEMPLATE(bm_get, std::int64_t)->Apply(bench::database_kinds);
+BENCHMARK_TEMPLATE(bm_get, std::uint64_t)->Apply(bench::database_kinds);
+BENCHMARK_TEMPLATE(bm_get, float)->Apply(bench::database_kinds);
+BENCHMARK_TEMPLATE(bm_get, double)->Apply(bench::database_kinds);
+BENCHMARK_TEMPLATE(bm_get, std::string)->Apply(bench::database_kinds);
+BENCHMARK_TEMPLATE(bm_get, std::vector<std::uint8_t>)->Apply(bench::database_kinds);
+BENCHMARK_TEMPLATE(bm_get, std::optional<std::int64_t>)->Apply(bench::database_kinds);
+BENCHMARK_TEMPLATE(bm_get, text_view)->Apply(bench::database_kinds);
+BENCHMARK_TEMPLATE(bm_get, blob_view)->Apply(bench::database_kinds);
+
+//! Zero values are the worst case for the checked numeric getters
+void bm_get_zero_checked(benchmark::State &state) {
+   connection con;
+   bench::open_database(con, static_cast<bench::database_kind>(state.range(0)));
+   bench::set_label(state);
+
+   statement stmt{con};
+   stmt.prepare("SELECT 0;");
+   stmt.step();
+
+   std::error_code ec;
+   std::int64_t value;
+   for (auto _ : state) {
+      stmt.get(0, value, ec);
+      benchmark::DoNotOptimize(value);
+   }
+}
+BENCHMARK(bm_get_zero_checked)->Apply(bench::database_kinds);
+
+void bm_get_zero_unchecked(benchmark::State &state) {
+   connection con;
+   bench::open_database(con, static_cast<bench::database_kind>(state.range(0)));
+   bench::set_label(state);
+
+   statement stmt{con};
+   stmt.prepare("SELECT 0;");
+   stmt.step();
+
+   std::int64_t value;
+   for (auto _ : state) {
+      stmt.get_unchecked(0, value);
+      benchmark::DoNotOptimize(value);
+   }
+}
+BENCHMARK(bm_get_zero_unchecked)->Apply(bench::database_kinds);
+
+void bm_get_by_name(benchmark::State &state) {
+   connection con;
+   bench::open_database(con, static_cast<bench::database_kind>(state.range(0)));
+   bench::set_label(state);
+
+   statement stmt{con};
+   stmt.prepare("SELECT int_value, real_value, text_value, blob_value FROM test WHERE id = 1;");
+   stmt.step();
+
+   std::int64_t value;
+   for (auto _ : state) {
+      stmt.get("int_value", value);
+      benchmark::DoNotOptimize(value);
+   }
+}
+BENCHMARK(bm_get_by_name)->Apply(bench::database_kinds);
+
+//! Single-shot execution, going through sqlite3_exec
+void bm_execute(benchmark::State &state) {
+   connection con;
+   bench::open_database(con, static_cast<bench::database_kind>(state.range(0)));
+   bench::set_label(state);
+
+   for (auto _ : state) {
+      statement::execute(con, "UPDATE test SET int_value = int_value + 1 WHERE id = 1;");
+   }
+}
+BENCHMARK(bm_execute)->Apply(bench::database_kinds);
+
+//! Same statement, but prepared once
+void bm_execute_prepared(benchmark::State &state) {
+   connection con;
+   bench::open_database(con, static_cast<bench::database_kind>(state.range(0)));
+   bench::set_label(state);
+
+   statement stmt{con};
+   stmt.prepare("UPDATE test SET int_value = int_value + 1 WHERE id = 1;");
+   for (auto _ : state) {
+      stmt.reset();
+      stmt.execute();
+   }
+}
+BENCHMARK(bm_execute_prepared)->Apply(bench::database_kinds);
+
+} // namespace
@@ -0,0 +1,56 @@
+/**
+ * @file   transaction.cpp
+ */
+
+#include "database.h"
+
+#include <sqlite-burrito/statement.h>
+#include <sqlite-burrito/transaction.h>
+
+using namespace sqlite_burrito;
+
+namespace {
+
+void bm_transaction_empty(benchmark::State &state) {
+   connection con;
+   bench::open_database(con, static_cast<bench::database_kind>(state.range(0)));
+   bench::set_label(state);
+
+   for (auto _ : state) {
+      transaction trans{con};
+      trans.commit();
+   }
+}
+BENCHMARK(bm_transaction_empty)->Apply(bench::database_kinds);
+
+void bm_transaction_update(benchmark::State &state) {
+   connection con;
+   bench::open_database(con, static_cast<bench::database_kind>(state.range(0)));
+   bench::set_label(state);
+
+   statement stmt{con};
+   stmt.prepare("UPDATE test SET int_value = int_value + 1 WHERE id = 1;");
+   for (auto _ : state) {
+      transaction trans{con};
+      stmt.reset();
+      stmt.execute();
+      trans.commit();
+   }
+}
+BENCHMARK(bm_transaction_update)->Apply(bench::database_kinds);
+
+void bm_transaction_nested(benchmark::State &state) {
+   connection con;
+   bench::open_database(con, static_cast<bench::database_kind>(state.range(0)));
+   bench::set_label(state);
+
+   transaction outer{con};
+   for (auto _ : state) {
+      transaction inner{con};
+      inner.commit();
+   }
+   outer.commit();
+}
+BENCHMARK(bm_transaction_nested)->Apply(bench::database_kinds);
+
+} // namespace
@@ -0,0 +1,55 @@
+/**
+ * @file   versioned_database.cpp
+ */
+
+#include "database.h"
+
+#include <sqlite-burrito/versioned_database.h>
+
+using namespace sqlite_burrito;
+
+namespace {
+
+void update(versioned_database &db, int from, std::error_code &ec) {
+   switch (from) {
+      case 0:
+         statement::execute(db.get_connection(),
+                            "CREATE TABLE metadata(version INTEGER); INSERT INTO metadata(version) VALUES (0);",
+                            ec);
+         break;
+
+      case 1:
+         statement::execute(db.get_connection(), "CREATE TABLE test(id INTEGER PRIMARY KEY, value TEXT);", ec);
+         break;
+
+      case 2:
+         statement::execute(db.get_connection(), "CREATE INDEX test_value ON test(value);", ec);
+         break;
+
+      default:
+         ec = std::make_error_code(std::errc::invalid_argument);
+         break;
+   }
+}
+
+//! In-memory databases are migrated from scratch each time, on-disk ones are only migrated on the first open
+void bm_versioned_database_open(benchmark::State &state) {
+   const auto kind = static_cast<bench::database_kind>(state.range(0));
+   const auto path = bench::database_path(kind);
+   bench::set_label(state);
+
+   if (kind == bench::database_kind::wal) {
+      // The journal mode is persistent, so it only has to be set once
+      connection con;
+      con.open(path);
+      statement::execute(con, "PRAGMA journal_mode = WAL;");
+   }
+
+   for (auto _ : state) {
+      versioned_database db;
+      db.open(path, 3, update);
+   }
+}
+BENCHMARK(bm_versioned_database_open)->Apply(bench::database_kinds);
+
+} // namespace
@@ -10,6 +10,9 @@ set(SB_TARGETS_EXPORT_NAME "${PROJECT_NAME}Targets")
 set(SB_INSTALL_NAMESPACE "${PROJECT_NAME}::")
 
 set(SB_INSTALL_TARGETS library)
+if(BUILD_COROUTINES)
+   list(APPEND SB_INSTALL_TARGETS coroutines)
+endif()
 
 write_basic_package_version_file(${SB_VERSION_CONFIG} COMPATIBILITY SameMajorVersion)
 configure_package_config_file(
@@ -56,6 +59,11 @@ install(
 set_target_properties(library PROPERTIES EXPORT_NAME library)
 add_library(SQLiteBurrito::library ALIAS library)
 
+if(BUILD_COROUTINES)
+   set_target_properties(coroutines PROPERTIES EXPORT_NAME coroutines)
+   add_library(SQLiteBurrito::coroutines ALIAS coroutines)
+endif()
+
 install(
    EXPORT ${SB_TARGETS_EXPORT_NAME}
    DESTINATION ${SB_INSTALL_CMAKE_DIR}
@@ -1,6 +1,6 @@
 from conan import ConanFile
 from conan.tools.files import copy, rmdir, load
-from conan.tools.cmake import CMake, cmake_layout
+from conan.tools.cmake import CMake, CMakeToolchain, cmake_layout
 from conan.tools.build import check_min_cppstd, can_run
 from conan.tools.env import VirtualRunEnv, Environment
 
@@ -15,16 +15,20 @@ class Recipe(ConanFile):
     url = "https://github.com/yowidin/sqlite-burrito"
     homepage = "https://github.com/yowidin/sqlite-burrito"
     package_type = "library"
-    generators = 'CMakeToolchain', 'CMakeDeps', 'VirtualRunEnv'
+    generators = 'CMakeDeps', 'VirtualRunEnv'
 
     settings = "os", "arch", "compiler", "build_type"
     options = {
         "shared": [True, False],
         "fPIC": [True, False],
+        "with_benchmarks": [True, False],
+        "with_coroutines": [True, False],
     }
     default_options = {
         "shared": False,
         "fPIC": True,
+        "with_benchmarks": False,
+        "with_coroutines": False,
     }
 
     exports_sources = '*', '!.git/*', '!build/*', '!cmake-build-*'
@@ -40,6 +44,10 @@ class Recipe(ConanFile):
         if self.options.shared:
             self.options.rm_safe("fPIC")
 
+    def package_id(self):
+        # Benchmarks are not a part of the package (the coroutine target and header are, so the option is kept)
+        del self.info.options.with_benchmarks
+
     def set_version(self):
         if self.version:
             return
@@ -59,6 +67,14 @@ class Recipe(ConanFile):
     def requirements(self):
         self.requires("sqlite3/3.49.1", transitive_headers=True, transitive_libs=True)
         self.test_requires("catch2/3.8.1")
+        if self.options.with_benchmarks:
+            self.test_requires("benchmark/1.9.1")
+
+    def generate(self):
+        tc = CMakeToolchain(self)
+        tc.cache_variables["BUILD_BENCHMARKS"] = bool(self.options.with_benchmarks)
+        tc.cache_variables["BUILD_COROUTINES"] = bool(self.options.with_coroutines)
+        tc.generate()
 
     def build(self):
         cmake = CMake(self)
@@ -88,6 +104,17 @@ class Recipe(ConanFile):
 
     def package_info(self):
         self.cpp_info.set_property("cmake_file_name", "SQLiteBurrito")
-        self.cpp_info.set_property("cmake_target_name", "SQLiteBurrito::library")
-        self.cpp_info.libs = ["SQLiteBurrito"]
-        self.cpp_info.requires = ["sqlite3::sqlite3"]
+
+        library = self.cpp_info.components["library"]
+        library.set_property("cmake_target_name", "SQLiteBurrito::library")
+        library.libs = ["SQLiteBurrito"]
+        library.requires = ["sqlite3::sqlite3"]
+        if self.settings.os in ["Linux", "FreeBSD"]:
+            library.system_libs = ["pthread"]
+
+        if self.options.with_coroutines:
+            # Header-only, but requires C++20 from the consumers (the library itself is built with C++17)
+            coroutines = self.cpp_info.components["coroutines"]
+            coroutines.set_property("cmake_target_name", "SQLiteBurrito::coroutines")
+            coroutines.requires = ["library"]
+            coroutines.cxxflags = ["/std:c++20"] if self.settings.compiler == "msvc" else ["-std=c++20"]
@@ -14,15 +14,23 @@
 
 using namespace sqlite_burrito;
 
+// Dummy entry type
+struct dummy_entry {
+   int first{};
+   std::optional<std::string> second{};
+   std::string third{};
+};
+
+// Entry members in the column order, used by `bind_row` and `get_row`
+template <>
+struct sqlite_burrito::row_traits<dummy_entry> {
+   static constexpr auto columns = std::make_tuple(&dummy_entry::first, &dummy_entry::second, &dummy_entry::third);
+};
+
 // Abstraction over a single database table
 class dummy_table {
 public:
-   // Dummy entry type
-   struct entry {
-      int first{};
-      std::optional<std::string> second{};
-      std::string third{};
-   };
+   using entry = dummy_entry;
 
 public:
    explicit dummy_table(connection &con)
@@ -41,9 +49,7 @@ public:
 
    void add_entry(const entry &e) {
       add_entry_.reset();
-      add_entry_.bind(":pfirst", e.first);
-      add_entry_.bind(":psecond", e.second);
-      add_entry_.bind(3, e.third);
+      add_entry_.bind_row(e);
       add_entry_.execute();
    }
 
@@ -52,10 +58,7 @@ public:
 
       select_all_.reset();
       while (select_all_.step()) {
-         auto &e = v.emplace_back();
-         select_all_.get(0, e.first);
-         select_all_.get(1, e.second);
-         select_all_.get(2, e.third);
+         select_all_.get_row(v.emplace_back());
       }
    }
 
@@ -67,9 +70,7 @@ public:
       }
 
       entry e{};
-      by_rowid_.get(0, e.first);
-      by_rowid_.get(1, e.second);
-      by_rowid_.get(2, e.third);
+      by_rowid_.get_row(e);
       return e;
    }
 
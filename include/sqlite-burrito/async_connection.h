@@ -0,0 +1,174 @@
+/**
+ * @file   async_connection.h
+ */
+#ifndef INCLUDE_SQLITE_BURRITO_ASYNC_CONNECTION_H
+#define INCLUDE_SQLITE_BURRITO_ASYNC_CONNECTION_H
+
+#include <sqlite-burrito/connection.h>
+#include <sqlite-burrito/export.h>
+
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace sqlite_burrito {
+
+/**
+ * A connection, owned by a dedicated worker thread. All database access happens on the worker: callers submit jobs
+ * (functions receiving the connection), which are executed one by one, in the submission order.
+ * The queue is bounded: submitting into a full queue blocks the caller until there is space, while the `try_*`
+ * variants fail right away with `std::errc::resource_unavailable_try_again` instead (e.g. for the event loop threads).
+ * Jobs submitted from the worker thread itself (e.g. follow-up jobs) are never blocked, to avoid self-deadlocks.
+ *
+ * @code
+ * async_connection db;
+ * db.open("app.db");
+ *
+ * auto count = db.submit([](connection &con) {
+ *    statement stmt{con};
+ *    stmt.prepare("SELECT COUNT(*) FROM users;");
+ *    stmt.step();
+ *
+ *    std::int64_t result = 0;
+ *    stmt.get(0, result);
+ *    return result;
+ * });
+ * @endcode
+ */
+class SQLITE_BURRITO_EXPORT async_connection {
+public:
+   struct options {
+      //! Maximal number of pending jobs (not counting the one being executed)
+      std::size_t queue_capacity{256};
+   };
+
+   //! Job type, exceptions escaping a job are ignored
+   using job_t = std::function<void(connection &con)>;
+
+public:
+   async_connection();
+   explicit async_connection(options opts);
+
+   async_connection(const async_connection &) = delete;
+   async_connection(async_connection &&) = delete;
+
+   //! Executes the pending jobs, and closes the connection (see `stop`)
+   ~async_connection();
+
+public:
+   async_connection &operator=(const async_connection &) = delete;
+   async_connection &operator=(async_connection &&) = delete;
+
+public:
+   //! Open the connection on the worker thread
+   std::future<void> open(std::string_view filename);
+   std::future<void> open(std::string_view filename, const connection_options &options);
+
+   /**
+    * Stop accepting new jobs, execute the pending ones, and wait for the worker thread to finish.
+    * Jobs submitted afterwards are rejected with `std::errc::operation_canceled`.
+    * @note Should not be called from within a job.
+    */
+   void stop() noexcept;
+
+   /**
+    * Enqueue a job, waiting for space in the queue if necessary.
+    * @throws std::system_error with `std::errc::operation_canceled` if the executor is stopped.
+    */
+   void post(job_t job);
+   void post(job_t job, std::error_code &ec);
+
+   //! Same as above, but fails with `std::errc::resource_unavailable_try_again` instead of waiting
+   void try_post(job_t job, std::error_code &ec);
+
+   /**
+    * Submit a function, receiving the connection. The function result (or its exception) is delivered via the
+    * returned future.
+    */
+   template <typename Func>
+   [[nodiscard]] auto submit(Func &&func) {
+      auto [job, result] = make_task(std::forward<Func>(func));
+      post(std::move(job));
+      return std::move(result);
+   }
+
+   //! Same as above, but fails instead of waiting for space in the queue (the returned future is not valid then)
+   template <typename Func>
+   [[nodiscard]] auto try_submit(Func &&func, std::error_code &ec) {
+      auto [job, result] = make_task(std::forward<Func>(func));
+      try_post(std::move(job), ec);
+      if (ec) {
+         result = {};
+      }
+      return std::move(result);
+   }
+
+   /**
+    * Submit a function, reporting its errors via the error code (e.g. `void(connection &con, std::error_code &ec)`),
+    * and a completion handler, invoked on the worker thread right after it, with the error code and the function
+    * result (if there is one): `void(std::error_code ec[, result_t result])`.
+    * @note The completion is not invoked if the function throws, so it should stick to the error code overloads.
+    */
+   template <typename Func, typename Completion>
+   void submit(Func &&func, Completion &&completion) {
+      post(make_callback_job(std::forward<Func>(func), std::forward<Completion>(completion)));
+   }
+
+   //! Same as above, but fails instead of waiting for space in the queue (the completion is not invoked then)
+   template <typename Func, typename Completion>
+   void try_submit(Func &&func, Completion &&completion, std::error_code &ec) {
+      try_post(make_callback_job(std::forward<Func>(func), std::forward<Completion>(completion)), ec);
+   }
+
+   //! @return Number of jobs waiting in the queue
+   [[nodiscard]] std::size_t pending() const noexcept;
+
+   //! @return true if called from the worker thread
+   [[nodiscard]] bool on_worker_thread() const noexcept;
+
+private:
+   template <typename Func>
+   static auto make_task(Func &&func) {
+      using result_t = std::invoke_result_t<std::decay_t<Func> &, connection &>;
+      using task_t = std::packaged_task<result_t(connection &)>;
+
+      // Packaged tasks are move-only, and jobs have to be copyable
+      auto task = std::make_shared<task_t>(std::forward<Func>(func));
+      auto result = task->get_future();
+      return std::make_pair(job_t{[task](connection &con) { (*task)(con); }}, std::move(result));
+   }
+
+   template <typename Func, typename Completion>
+   static job_t make_callback_job(Func &&func, Completion &&completion) {
+      using result_t = std::invoke_result_t<std::decay_t<Func> &, connection &, std::error_code &>;
+      using state_t = std::pair<std::decay_t<Func>, std::decay_t<Completion>>;
+
+      auto state = std::make_shared<state_t>(std::forward<Func>(func), std::forward<Completion>(completion));
+      return [state](connection &con) {
+         std::error_code ec;
+         if constexpr (std::is_void_v<result_t>) {
+            state->first(con, ec);
+            state->second(ec);
+         } else {
+            auto result = state->first(con, ec);
+            state->second(ec, std::move(result));
+         }
+      };
+   }
+
+private:
+   options options_;
+
+   //! Same Pimpl reasoning as in the statement class
+   struct impl;
+   impl *impl_;
+};
+
+} // namespace sqlite_burrito
+
+#endif // INCLUDE_SQLITE_BURRITO_ASYNC_CONNECTION_H
@@ -0,0 +1,95 @@
+/**
+ * @file   backup.h
+ */
+#ifndef INCLUDE_SQLITE_BURRITO_BACKUP_H
+#define INCLUDE_SQLITE_BURRITO_BACKUP_H
+
+#include <sqlite-burrito/export.h>
+
+#include <chrono>
+#include <functional>
+#include <system_error>
+
+namespace sqlite_burrito {
+
+class connection;
+
+/**
+ * Online backup of the main database from one connection into another.
+ * The source is copied in steps of a configurable number of pages. The source lock is only held during a step, so
+ * writers can make progress in between. If the source is modified by another connection in the meantime, the backup
+ * restarts automatically (modifications made through the source connection itself are copied as they happen).
+ */
+class SQLITE_BURRITO_EXPORT backup {
+public:
+   struct options {
+      //! Number of pages to copy per step (0 or negative to copy everything in a single step)
+      int pages_per_step{100};
+
+      //! Delay between the steps, releasing the source for the writers. Locked steps are retried after at least
+      //! 1ms, even with a zero delay.
+      std::chrono::milliseconds step_delay{10};
+
+      //! Maximal number of consecutive retries of a locked step, before giving up with SQLITE_BUSY or SQLITE_LOCKED
+      //! (0 retries until the backup is canceled)
+      int max_busy_retries{0};
+   };
+
+   struct progress {
+      //! Number of pages, which still have to be copied
+      int remaining{0};
+
+      //! Total number of pages in the source database
+      int total{0};
+
+      //! @return Completed fraction of the backup (0 to 1)
+      [[nodiscard]] double fraction() const noexcept {
+         return total > 0 ? static_cast<double>(total - remaining) / static_cast<double>(total) : 0.0;
+      }
+   };
+
+   //! Progress callback, called after each step. Returning false cancels the backup.
+   using progress_funct_t = std::function<bool(const progress &progress)>;
+
+public:
+   backup(connection &source, connection &destination);
+   backup(connection &source, connection &destination, options opts);
+
+   backup(const backup &) = delete;
+   backup(backup &&) = delete;
+
+   ~backup();
+
+public:
+   backup &operator=(const backup &) = delete;
+   backup &operator=(backup &&) = delete;
+
+public:
+   /**
+    * Run the backup until it's completed, failed, or canceled (reported as `std::errc::operation_canceled`).
+    * Steps, which could not lock the source or destination database are retried after the step delay (see
+    * `options::max_busy_retries`). The destination is left unchanged, unless the backup is completed.
+    * @param callback Progress callback (optional).
+    */
+   void run(const progress_funct_t &callback = {});
+   void run(const progress_funct_t &callback, std::error_code &ec);
+
+   //! Cancel a running backup, can be called from any thread
+   void cancel() noexcept;
+
+   //! @return Progress, as of the last step
+   [[nodiscard]] progress get_progress() const noexcept;
+
+private:
+   //! Source and destination database connections
+   connection *source_;
+   connection *destination_;
+
+   //! Same Pimpl reasoning as in the statement class
+   struct impl;
+   impl *impl_;
+};
+
+} // namespace sqlite_burrito
+
+#endif // INCLUDE_SQLITE_BURRITO_BACKUP_H
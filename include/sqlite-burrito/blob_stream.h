@@ -0,0 +1,132 @@
+/**
+ * @file   blob_stream.h
+ */
+#ifndef INCLUDE_SQLITE_BURRITO_BLOB_STREAM_H
+#define INCLUDE_SQLITE_BURRITO_BLOB_STREAM_H
+
+#include <sqlite-burrito/export.h>
+
+#include <sqlite3.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+#include <system_error>
+
+namespace sqlite_burrito {
+
+class connection;
+
+/**
+ * Incremental access to a single blob value, without loading it into memory as a whole.
+ * Blob streams cannot change the blob size: larger values should be inserted as zero-filled blobs of the final size
+ * first (see `statement::bind_zeroblob`), and then written in chunks. For example:
+ *
+ * @code
+ * statement insert{con};
+ * insert.prepare("INSERT INTO attachments(data) VALUES (:pdata);");
+ * insert.bind_zeroblob(":pdata", file_size);
+ * insert.execute();
+ *
+ * blob_stream blob{con};
+ * blob.open("attachments", "data", con.last_insert_rowid(), blob_stream::mode::read_write);
+ * blob.write_from(file);
+ * @endcode
+ *
+ * The stream is invalidated (and reports SQLITE_ABORT) if the row it's pointing to is modified or deleted.
+ */
+class SQLITE_BURRITO_EXPORT blob_stream {
+public:
+   enum class mode : int {
+      read_only = 0,
+      read_write = 1,
+   };
+
+   using native_handle_t = ::sqlite3_blob *;
+
+   //! Default chunk size, used when copying from and to the standard streams
+   static constexpr std::size_t default_chunk_size = 64 * 1024;
+
+public:
+   explicit blob_stream(connection &con);
+
+   blob_stream(const blob_stream &) = delete;
+   blob_stream(blob_stream &&other) noexcept;
+
+   ~blob_stream();
+
+public:
+   blob_stream &operator=(const blob_stream &) = delete;
+   blob_stream &operator=(blob_stream &&other) noexcept;
+
+public:
+   /**
+    * Open a blob in the main database, closing the currently open one (if any).
+    * @param table Table name.
+    * @param column Column name.
+    * @param rowid Row ID.
+    * @param mode Access mode.
+    */
+   void open(std::string_view table, std::string_view column, std::int64_t rowid, mode mode = mode::read_only);
+   void open(std::string_view table,
+             std::string_view column,
+             std::int64_t rowid,
+             mode mode,
+             std::error_code &ec) noexcept;
+
+   //! Move to another row of the same table and column, without the overhead of opening a new blob handle.
+   void reopen(std::int64_t rowid);
+   void reopen(std::int64_t rowid, std::error_code &ec) noexcept;
+
+   void close() noexcept;
+
+   [[nodiscard]] bool is_open() const noexcept { return blob_ != nullptr; }
+
+   //! @return Blob size in bytes
+   [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+   //! @return Current position for the sequential reads and writes
+   [[nodiscard]] std::size_t tell() const noexcept { return position_; }
+
+   //! Set the position for the sequential reads and writes (clamped to the blob size)
+   void seek(std::size_t position) noexcept;
+
+   /**
+    * Read up to `size` bytes, starting at the current position, and advance the position.
+    * @return Number of bytes read (less than `size` only at the end of the blob).
+    */
+   std::size_t read(void *data, std::size_t size);
+   std::size_t read(void *data, std::size_t size, std::error_code &ec) noexcept;
+
+   /**
+    * Write `size` bytes at the current position, and advance the position.
+    * Writing past the end of the blob is an error.
+    */
+   void write(const void *data, std::size_t size);
+   void write(const void *data, std::size_t size, std::error_code &ec) noexcept;
+
+   //! Read the rest of the blob into the output stream, using a fixed-size buffer
+   void read_into(std::ostream &output, std::size_t chunk_size = default_chunk_size);
+   void read_into(std::ostream &output, std::size_t chunk_size, std::error_code &ec);
+
+   //! Fill the rest of the blob from the input stream, using a fixed-size buffer. The input should have enough data.
+   void write_from(std::istream &input, std::size_t chunk_size = default_chunk_size);
+   void write_from(std::istream &input, std::size_t chunk_size, std::error_code &ec);
+
+   [[nodiscard]] native_handle_t native_handle() const noexcept { return blob_; }
+
+private:
+   //! Database connection, this blob belongs to
+   connection *connection_;
+
+   //! Native handle
+   native_handle_t blob_{nullptr};
+
+   std::size_t size_{0};
+   std::size_t position_{0};
+};
+
+} // namespace sqlite_burrito
+
+#endif // INCLUDE_SQLITE_BURRITO_BLOB_STREAM_H
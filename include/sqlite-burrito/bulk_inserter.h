@@ -0,0 +1,199 @@
+/**
+ * @file   bulk_inserter.h
+ */
+#ifndef INCLUDE_SQLITE_BURRITO_BULK_INSERTER_H
+#define INCLUDE_SQLITE_BURRITO_BULK_INSERTER_H
+
+#include <sqlite-burrito/connection.h>
+#include <sqlite-burrito/export.h>
+#include <sqlite-burrito/statement.h>
+#include <sqlite-burrito/transaction.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+namespace sqlite_burrito {
+
+//! Inserts rows using a single prepared statement, grouping them into IMMEDIATE transactions, which are committed
+//! every N rows or T milliseconds (whichever comes first). Any rows, still pending at destruction, are committed.
+//! The limits are checked on each insert: an idle inserter keeps its batch (and the write lock) open, unless
+//! `flush_if_due` is called periodically.
+class SQLITE_BURRITO_EXPORT bulk_inserter {
+public:
+   using clock_t = std::chrono::steady_clock;
+
+   struct options {
+      //! Commit after this many rows (0 disables the row-based commits)
+      std::size_t batch_rows{1000};
+
+      //! Commit when the batch is older than this (0 disables the time-based commits)
+      std::chrono::milliseconds batch_time{100};
+   };
+
+   struct statistics {
+      //! Number of rows committed so far
+      std::uint64_t rows{0};
+
+      //! Number of commits performed so far
+      std::uint64_t commits{0};
+
+      //! Time between the first inserted row and the last commit
+      clock_t::duration elapsed{0};
+
+      //! Commit latencies
+      clock_t::duration total_commit_time{0};
+      clock_t::duration max_commit_time{0};
+
+      [[nodiscard]] double rows_per_second() const noexcept;
+      [[nodiscard]] clock_t::duration average_commit_time() const noexcept;
+   };
+
+public:
+   /**
+    * @param con Database connection, the insert statement belongs to
+    * @param insert Prepared insert statement, should outlive the inserter
+    */
+   bulk_inserter(connection &con, statement &insert);
+   bulk_inserter(connection &con, statement &insert, options opts);
+
+   bulk_inserter(const bulk_inserter &) = delete;
+   bulk_inserter(bulk_inserter &&) = delete;
+
+   ~bulk_inserter();
+
+public:
+   bulk_inserter &operator=(const bulk_inserter &) = delete;
+   bulk_inserter &operator=(bulk_inserter &&) = delete;
+
+public:
+   /**
+    * Insert a single row, binding the values positionally (starting from the parameter index 1).
+    */
+   template <typename... Args>
+   void insert(const Args &...args);
+
+   template <typename... Args>
+   void insert(std::error_code &ec, const Args &...args);
+
+   /**
+    * Insert a single row, binding the tuple elements positionally (starting from the parameter index 1).
+    */
+   template <typename... Args>
+   void insert_tuple(const std::tuple<Args...> &row);
+
+   template <typename... Args>
+   void insert_tuple(const std::tuple<Args...> &row, std::error_code &ec);
+
+   /**
+    * Insert a single row, using a custom binder.
+    * @param binder Callable with the `void(statement &stmt, std::error_code &ec)` signature, binding the row values.
+    */
+   template <typename Binder>
+   void insert_with(Binder &&binder);
+
+   template <typename Binder>
+   void insert_with(Binder &&binder, std::error_code &ec);
+
+   //! Commit all pending rows. A failed commit (e.g. SQLITE_BUSY) keeps the batch open, so it can be retried.
+   void flush();
+   void flush(std::error_code &ec) noexcept;
+
+   //! Commit the pending rows, if the current batch is older than the batch time (e.g. from an idle timer)
+   void flush_if_due();
+   void flush_if_due(std::error_code &ec) noexcept;
+
+   //! Roll back all pending rows
+   void discard() noexcept;
+
+   [[nodiscard]] std::size_t pending() const noexcept { return pending_; }
+   [[nodiscard]] const statistics &stats() const noexcept { return stats_; }
+
+private:
+   void begin_row(std::error_code &ec) noexcept;
+   void end_row(std::error_code &ec) noexcept;
+
+private:
+   //! Database connection
+   connection *con_;
+
+   //! Insert statement
+   statement *insert_;
+
+   options options_;
+   statistics stats_{};
+
+   //! Currently open batch transaction
+   std::optional<transaction> batch_{};
+
+   //! Start of the current batch and of the very first one
+   clock_t::time_point batch_start_{};
+   clock_t::time_point first_start_{};
+
+   //! Number of rows in the current batch
+   std::size_t pending_{0};
+};
+
+template <typename... Args>
+void bulk_inserter::insert(const Args &...args) {
+   std::error_code ec;
+   insert(ec, args...);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+template <typename... Args>
+void bulk_inserter::insert(std::error_code &ec, const Args &...args) {
+   insert_tuple(std::tie(args...), ec);
+}
+
+template <typename... Args>
+void bulk_inserter::insert_tuple(const std::tuple<Args...> &row) {
+   std::error_code ec;
+   insert_tuple(row, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+template <typename... Args>
+void bulk_inserter::insert_tuple(const std::tuple<Args...> &row, std::error_code &ec) {
+   insert_with(
+       [&row](statement &stmt, std::error_code &bind_ec) {
+          std::apply([&](const auto &...values) { stmt.bind_all(bind_ec, values...); }, row);
+       },
+       ec);
+}
+
+template <typename Binder>
+void bulk_inserter::insert_with(Binder &&binder) {
+   std::error_code ec;
+   insert_with(std::forward<Binder>(binder), ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+template <typename Binder>
+void bulk_inserter::insert_with(Binder &&binder, std::error_code &ec) {
+   begin_row(ec);
+   if (ec) {
+      return;
+   }
+
+   binder(*insert_, ec);
+   if (ec) {
+      return;
+   }
+
+   end_row(ec);
+}
+
+} // namespace sqlite_burrito
+
+#endif // INCLUDE_SQLITE_BURRITO_BULK_INSERTER_H
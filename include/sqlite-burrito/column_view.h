@@ -0,0 +1,80 @@
+/**
+ * @file   column_view.h
+ */
+#ifndef INCLUDE_SQLITE_BURRITO_COLUMN_VIEW_H
+#define INCLUDE_SQLITE_BURRITO_COLUMN_VIEW_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace sqlite_burrito {
+
+/**
+ * Non-owning view into the column value of the current statement row.
+ * The view is pointing directly into the SQLite's row buffer, and is only valid until the next `step()`, `reset()` or
+ * `prepare()` call on the statement it was obtained from. Debug builds assert on any data access via an invalidated
+ * view. Views keep tracking the statement, if it's moved, but should not outlive it.
+ */
+template <typename T>
+class column_view {
+public:
+   using value_type = T;
+   using size_type = std::size_t;
+   using const_pointer = const T *;
+   using const_iterator = const T *;
+
+public:
+   column_view() = default;
+
+   column_view(const T *data, size_type size, const std::uint64_t *generation) noexcept
+      : data_{data}
+      , size_{size}
+      , source_{generation}
+      , generation_{generation ? *generation : 0} {
+      // Nothing to do here
+   }
+
+public:
+   //! @return true if the row this view was obtained from is still the current one
+   [[nodiscard]] bool valid() const noexcept { return !source_ || *source_ == generation_; }
+
+   [[nodiscard]] const_pointer data() const noexcept {
+      assert(valid() && "Accessing a column view after the statement was stepped or reset");
+      return data_;
+   }
+
+   [[nodiscard]] size_type size() const noexcept { return size_; }
+   [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+   [[nodiscard]] const_iterator begin() const noexcept { return data(); }
+   [[nodiscard]] const_iterator end() const noexcept { return data() + size_; }
+
+   [[nodiscard]] const T &operator[](size_type idx) const noexcept {
+      assert(idx < size_);
+      return data()[idx];
+   }
+
+   //! Text views are implicitly convertible to std::string_view (the validity checks are lost after the conversion)
+   template <typename U = T, typename = std::enable_if_t<std::is_same_v<U, char>>>
+   operator std::string_view() const noexcept {
+      return {data(), size_};
+   }
+
+private:
+   const T *data_{nullptr};
+   size_type size_{0};
+
+   //! Row generation counter of the source statement, and its value at the time of the view construction
+   const std::uint64_t *source_{nullptr};
+   std::uint64_t generation_{0};
+};
+
+using text_view = column_view<char>;
+using blob_view = column_view<std::byte>;
+
+} // namespace sqlite_burrito
+
+#endif // INCLUDE_SQLITE_BURRITO_COLUMN_VIEW_H
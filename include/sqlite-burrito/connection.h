@@ -7,19 +7,26 @@
 #define INCLUDE_SQLITE_BURRITO_CONNECTION_H
 
 #include <sqlite-burrito/config.h>
+#include <sqlite-burrito/connection_options.h>
+#include <sqlite-burrito/database_image.h>
 #include <sqlite-burrito/export.h>
+#include <sqlite-burrito/status.h>
 #include <sqlite-burrito/transaction.h>
 
 #include <sqlite3.h>
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <vector>
 
 namespace sqlite_burrito {
 
+class statement_cache;
+
 class SQLITE_BURRITO_EXPORT connection {
 public:
    enum class open_flags : int {
@@ -67,24 +74,212 @@ public:
       private_cache = SQLITE_OPEN_PRIVATECACHE,
    };
 
+   //! Options for `deserialize`
+   enum class deserialize_flags : int {
+      none = 0,
+
+      //! The database can grow beyond the image size (the buffer is reallocated by SQLite as needed). Without this
+      //! flag, writes that need more space fail with SQLITE_FULL.
+      resizeable = SQLITE_DESERIALIZE_RESIZEABLE,
+
+      //! The database is read-only, writes fail with SQLITE_READONLY.
+      readonly = SQLITE_DESERIALIZE_READONLY,
+   };
+
    using native_handle_t = ::sqlite3 *;
 
+   //! Retry policy for the SQLITE_BUSY errors, see `set_busy_policy`
+   struct busy_policy {
+      //! Total time to keep retrying a single busy event, before giving up with SQLITE_BUSY
+      std::chrono::milliseconds timeout{5000};
+
+      //! Delay before the first retry, doubled on each following one
+      std::chrono::microseconds initial_delay{100};
+
+      //! Upper limit for a single retry delay
+      std::chrono::microseconds max_delay{std::chrono::milliseconds{100}};
+
+      //! Random jitter, as a fraction of the delay (0 to 1): delays are picked from [delay * (1 - jitter), delay]
+      double jitter{0.5};
+
+      //! Maximal number of retries for a single busy event (0 means only the timeout is applied)
+      int max_retries{0};
+   };
+
+   //! Page cache and memory-mapped I/O counters, see `io_stats`
+   struct io_statistics {
+      //! Memory-mapped I/O limit for the main database, in bytes (0 if disabled)
+      std::int64_t mmap_size{0};
+
+      //! Page cache hits and misses. Pages, read via memory-mapped I/O bypass the page cache, and are not counted.
+      std::uint64_t cache_hits{0};
+      std::uint64_t cache_misses{0};
+
+      //! Number of dirty cache pages written to disk, on commits and because of the cache pressure
+      std::uint64_t cache_writes{0};
+      std::uint64_t cache_spills{0};
+
+      //! @return Fraction of page requests, served from the page cache (0 to 1)
+      [[nodiscard]] double hit_ratio() const noexcept {
+         const auto total = cache_hits + cache_misses;
+         return total ? static_cast<double>(cache_hits) / static_cast<double>(total) : 0.0;
+      }
+   };
+
+   //! Connection memory statistics, see https://www.sqlite.org/c3ref/c_dbstatus_options.html
+   struct statistics {
+      //! Number of lookaside memory slots in use
+      status_counter lookaside_used{};
+
+      //! Number of allocations served from the lookaside memory (high-water only)
+      status_counter lookaside_hits{};
+
+      //! Number of allocations, which were too large for the lookaside memory (high-water only)
+      status_counter lookaside_misses_size{};
+
+      //! Number of allocations, which failed because the lookaside memory was full (high-water only)
+      status_counter lookaside_misses_full{};
+
+      //! Heap memory, used by the page cache, in bytes. Shared caches are accounted in full (`cache_used`), or
+      //! divided between the connections, sharing them (`cache_used_shared`)
+      std::int64_t cache_used{0};
+      std::int64_t cache_used_shared{0};
+
+      //! Heap memory, used to store the schemas for all attached databases, in bytes
+      std::int64_t schema_used{0};
+
+      //! Heap memory, used by all the prepared statements, in bytes
+      std::int64_t statement_used{0};
+
+      //! Page cache and memory-mapped I/O counters
+      io_statistics io{};
+   };
+
+   //! Lock contention counters, accumulated over the connection lifetime
+   struct busy_statistics {
+      //! Number of times the connection encountered a lock (a single event may be retried multiple times)
+      std::uint64_t events{0};
+
+      //! Number of retries over all events
+      std::uint64_t retries{0};
+
+      //! Number of events, which resulted in SQLITE_BUSY being reported to the caller
+      std::uint64_t failures{0};
+
+      //! Total time spent waiting for the locks
+      std::chrono::nanoseconds wait_time{0};
+   };
+
 public:
    explicit connection(open_flags flags = open_flags::default_mode);
 
+   //! Not movable: the busy handler, the statement cache and the statements are referencing the connection object
+   //! (use a `std::unique_ptr<connection>` to transfer the ownership)
    connection(connection &) = delete;
-   connection(connection &&) = default;
+   connection(connection &&) = delete;
 
    ~connection();
 
 public:
    connection &operator=(connection &) = delete;
-   connection &operator=(connection &&) = default;
+   connection &operator=(connection &&) = delete;
 
 public:
    void open(std::string_view filename);
    void open(std::string_view filename, std::error_code &ec) noexcept;
 
+   /**
+    * Open a database and apply the options to it (see `connection_options` for the presets).
+    * The options are applied before the new connection replaces the current one: if any of them fails, the new
+    * connection is closed, and the current one is kept intact. A journal mode, which the database doesn't support
+    * (e.g. WAL for an in-memory database) fails with `std::errc::not_supported`.
+    * @param filename Database file name.
+    * @param options Connection options.
+    */
+   void open(std::string_view filename, const connection_options &options);
+   void open(std::string_view filename, const connection_options &options, std::error_code &ec) noexcept;
+
+   /**
+    * Close the connection without waiting for the outstanding statements.
+    * Statements, which are still alive (prepared, but not yet destroyed), do not block the close: the connection
+    * becomes a "zombie", and is released by SQLite once the last of them is finalized (see `sqlite3_close_v2`).
+    * Statements, owned by the connection itself (the statement cache and the transaction control statements) are
+    * finalized beforehand.
+    * @return SQL text of the statements, which were still alive at the time of closing (empty on a clean close).
+    */
+   std::vector<std::string> close();
+   std::vector<std::string> close(std::error_code &ec);
+
+   /**
+    * @return SQL text of all statements, currently prepared on this connection, including the ones used internally.
+    */
+   [[nodiscard]] std::vector<std::string> outstanding_statements() const;
+
+public:
+   /**
+    * Install a busy handler, retrying locked operations with an exponential backoff.
+    * The policy is kept across re-opening the connection. Same as with SQLite itself, calling
+    * `sqlite3_busy_timeout` on the native handle replaces the handler.
+    */
+   void set_busy_policy(const busy_policy &policy);
+   void set_busy_policy(const busy_policy &policy, std::error_code &ec) noexcept;
+
+   //! Remove the busy handler, locked operations will fail with SQLITE_BUSY immediately. The counters are kept.
+   void clear_busy_policy() noexcept;
+
+   //! @return Lock contention counters (updated atomically, so they can be read from the metrics threads)
+   [[nodiscard]] busy_statistics busy_stats() const noexcept;
+
+public:
+   /**
+    * Set the maximal number of bytes of the database file to access via memory-mapped I/O (0 disables it).
+    * The value is clamped by SQLite to its compile-time limit.
+    * @return Effective limit.
+    */
+   std::int64_t set_mmap_size(std::int64_t bytes);
+   std::int64_t set_mmap_size(std::int64_t bytes, std::error_code &ec) noexcept;
+
+   //! @return Current memory-mapped I/O limit for the main database.
+   [[nodiscard]] std::int64_t mmap_size();
+   [[nodiscard]] std::int64_t mmap_size(std::error_code &ec) noexcept;
+
+   /**
+    * @param reset Reset the page cache counters after reading them
+    * @return Page cache and memory-mapped I/O counters, accumulated since the connection was opened (or reset).
+    *         Fails with SQLITE_MISUSE if the connection is not open.
+    */
+   [[nodiscard]] io_statistics io_stats(bool reset = false);
+   [[nodiscard]] io_statistics io_stats(bool reset, std::error_code &ec) noexcept;
+
+   /**
+    * Get a snapshot of the connection memory statistics (see `global_stats` for the process-wide ones).
+    * Fails with SQLITE_MISUSE if the connection is not open.
+    * @param reset_highwater Reset the lookaside high-water marks, after reading them (page cache counters are not
+    *                        reset, see `io_stats` for that).
+    */
+   [[nodiscard]] statistics stats(bool reset_highwater = false);
+   [[nodiscard]] statistics stats(bool reset_highwater, std::error_code &ec) noexcept;
+
+public:
+   /**
+    * Serialize the main database into a memory image (the same bytes, as the database would have on disk). Works for
+    * both in-memory and file databases, the latter are read in a single pass.
+    * Fails with SQLITE_MISUSE if the connection is not open.
+    */
+   [[nodiscard]] database_image serialize();
+   [[nodiscard]] database_image serialize(std::error_code &ec) noexcept;
+
+   /**
+    * Replace the main database with an in-memory one, backed by the image. The image ownership is transferred to
+    * SQLite without copying (even if the call fails), and the buffer is released when the connection is closed.
+    * The connection should be open (an in-memory one is enough, otherwise fails with SQLITE_MISUSE), without any
+    * pending transactions.
+    * @param image Database image, e.g. from `serialize` or `database_image::allocate`.
+    * @param flags Deserialization options.
+    */
+   void deserialize(database_image &&image, deserialize_flags flags = deserialize_flags::resizeable);
+   void deserialize(database_image &&image, deserialize_flags flags, std::error_code &ec) noexcept;
+
 public:
    [[nodiscard]] std::int64_t last_insert_rowid();
 
@@ -96,12 +291,63 @@ public:
    [[nodiscard]] transaction begin_transaction(
        transaction::behavior behavior = transaction::behavior::default_behavior);
 
+   /**
+    * @return Prepared statements cache, owned by this connection (created on first access).
+    */
+   [[nodiscard]] statement_cache &cache();
+
+private:
+   friend class transaction;
+
+   //! Transaction control statements, prepared once per connection
+   enum class control : int {
+      begin_deferred,
+      begin_immediate,
+      begin_exclusive,
+      commit,
+      rollback,
+
+      count,
+   };
+
+   //! Savepoint control statements, prepared once per nesting depth
+   enum class savepoint_control : int {
+      begin,
+      release,
+      rollback,
+
+      count,
+   };
+
+   void execute_control(control kind, std::error_code &ec) noexcept;
+   void execute_savepoint_control(savepoint_control kind, int depth, std::error_code &ec) noexcept;
+   void finalize_control() noexcept;
+
+   static int on_busy(void *ptr, int count) noexcept;
+
 private:
    //! Database open flags
    open_flags flags_;
 
    //! Native handle
    native_handle_t connection_;
+
+   //! Prepared statements cache
+   statement_cache *cache_{nullptr};
+
+   //! Lazily prepared transaction control statements
+   ::sqlite3_stmt *control_[static_cast<int>(control::count)]{};
+
+   //! Lazily prepared savepoint control statements (Pimpl, same reasoning as in the statement class)
+   struct savepoint_statements;
+   savepoint_statements *savepoints_{nullptr};
+
+   //! Current savepoint nesting depth (0 if there are no nested transactions)
+   int savepoint_depth_{0};
+
+   //! Busy policy and contention counters (same Pimpl reasoning as above)
+   struct busy_state;
+   busy_state *busy_{nullptr};
 };
 
 } // namespace sqlite_burrito
@@ -119,4 +365,10 @@ SQLITE_BURRITO_EXPORT constexpr inline sqlite_burrito::connection::open_flags &o
    return lhs;
 }
 
+SQLITE_BURRITO_EXPORT constexpr inline sqlite_burrito::connection::deserialize_flags operator|(
+    sqlite_burrito::connection::deserialize_flags lhs,
+    sqlite_burrito::connection::deserialize_flags rhs) {
+   return static_cast<sqlite_burrito::connection::deserialize_flags>(static_cast<int>(lhs) | static_cast<int>(rhs));
+}
+
 #endif /* INCLUDE_SQLITE_BURRITO_CONNECTION_H */
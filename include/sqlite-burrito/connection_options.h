@@ -0,0 +1,101 @@
+/**
+ * @file   connection_options.h
+ */
+#ifndef INCLUDE_SQLITE_BURRITO_CONNECTION_OPTIONS_H
+#define INCLUDE_SQLITE_BURRITO_CONNECTION_OPTIONS_H
+
+#include <cstdint>
+#include <optional>
+
+namespace sqlite_burrito {
+
+//! Typed connection settings, applied with the corresponding PRAGMA statements when a connection is opened.
+//! Unset values are left at the SQLite (or database file) defaults. See https://www.sqlite.org/pragma.html for the
+//! meaning of each setting.
+struct connection_options {
+   enum class journal_mode {
+      delete_journal,
+      truncate,
+      persist,
+      memory,
+      wal,
+      off,
+   };
+
+   enum class synchronous_mode {
+      off,
+      normal,
+      full,
+      extra,
+   };
+
+   enum class temp_store_mode {
+      default_store,
+      file,
+      memory,
+   };
+
+   enum class locking_mode_t {
+      normal,
+      exclusive,
+   };
+
+   //! Only has an effect before the database is created, or before switching it into the WAL mode
+   std::optional<int> page_size{};
+
+   std::optional<locking_mode_t> locking_mode{};
+   std::optional<journal_mode> journal{};
+   std::optional<synchronous_mode> synchronous{};
+
+   //! Page cache size: number of pages if positive, or the size in KiB if negative
+   std::optional<std::int64_t> cache_size{};
+
+   //! Maximal number of bytes to access via the memory-mapped I/O (0 disables it)
+   std::optional<std::int64_t> mmap_size{};
+
+   std::optional<temp_store_mode> temp_store{};
+
+   //! WAL auto-checkpoint interval, in pages (0 disables the automatic checkpoints)
+   std::optional<int> wal_autocheckpoint{};
+
+   std::optional<bool> foreign_keys{};
+
+   //! Crash-safe settings: WAL with full synchronization, and enforced foreign keys
+   static connection_options durable() {
+      connection_options result;
+      result.journal = journal_mode::wal;
+      result.synchronous = synchronous_mode::full;
+      result.foreign_keys = true;
+      return result;
+   }
+
+   //! Fast, but still consistent settings: WAL with synchronization on checkpoints only, a larger page cache,
+   //! memory-mapped reads, and in-memory temporary tables. The last transactions might be lost on power failure.
+   static connection_options throughput() {
+      connection_options result;
+      result.journal = journal_mode::wal;
+      result.synchronous = synchronous_mode::normal;
+      result.cache_size = -64 * 1024;
+      result.mmap_size = 256 * 1024 * 1024;
+      result.temp_store = temp_store_mode::memory;
+      result.foreign_keys = true;
+      return result;
+   }
+
+   //! Settings for the initial population of a database, by a single connection: no synchronization, in-memory
+   //! rollback journal and an exclusive lock. The database might get corrupted on a crash.
+   static connection_options bulk_load() {
+      connection_options result;
+      result.locking_mode = locking_mode_t::exclusive;
+      result.journal = journal_mode::memory;
+      result.synchronous = synchronous_mode::off;
+      result.cache_size = -256 * 1024;
+      result.temp_store = temp_store_mode::memory;
+      result.wal_autocheckpoint = 0;
+      return result;
+   }
+};
+
+} // namespace sqlite_burrito
+
+#endif // INCLUDE_SQLITE_BURRITO_CONNECTION_OPTIONS_H
@@ -0,0 +1,183 @@
+/**
+ * @file   connection_pool.h
+ */
+#ifndef INCLUDE_SQLITE_BURRITO_CONNECTION_POOL_H
+#define INCLUDE_SQLITE_BURRITO_CONNECTION_POOL_H
+
+#include <sqlite-burrito/connection.h>
+#include <sqlite-burrito/export.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace sqlite_burrito {
+
+//! A pool of connections to the same database file: one writer, and a number of read-only readers.
+//! Intended for the WAL databases, where readers are not blocked by the writer. Connections are handed out as leases,
+//! each leased connection should only be used by one thread at a time, the pool itself is thread-safe.
+class SQLITE_BURRITO_EXPORT connection_pool {
+public:
+   struct options {
+      //! Number of read-only connections (0 means that reads are served by the writer)
+      std::size_t readers{4};
+
+      //! Settings, applied to all connections on open (see `connection::open`). The journal mode is only applied by
+      //! the writer, the readers are using the one of the database file.
+      connection_options settings{wal_settings()};
+
+      //! Busy timeout, applied to all connections (see `connection::busy_policy`)
+      std::chrono::milliseconds busy_timeout{5000};
+
+      //! Additional SQL statements, executed on each connection after it is opened (for the settings, which are not
+      //! covered by `connection_options`)
+      std::vector<std::string> pragmas{};
+
+      //! @return Default settings: the WAL journal mode, everything else is left at the SQLite defaults
+      static connection_options wal_settings() {
+         connection_options result;
+         result.journal = connection_options::journal_mode::wal;
+         return result;
+      }
+   };
+
+   struct statistics {
+      //! Number of successful acquisitions
+      std::uint64_t reader_acquisitions{0};
+      std::uint64_t writer_acquisitions{0};
+
+      //! Number of acquisitions, which timed out
+      std::uint64_t timeouts{0};
+
+      //! Total and maximal time spent waiting for a connection to become available
+      std::chrono::nanoseconds reader_wait_time{0};
+      std::chrono::nanoseconds writer_wait_time{0};
+      std::chrono::nanoseconds max_reader_wait_time{0};
+      std::chrono::nanoseconds max_writer_wait_time{0};
+
+      //! Total time the connections were leased out
+      std::chrono::nanoseconds reader_busy_time{0};
+      std::chrono::nanoseconds writer_busy_time{0};
+
+      //! Number of currently leased connections
+      std::size_t readers_in_use{0};
+      std::size_t writers_in_use{0};
+
+      //! Number of read-only connections
+      std::size_t readers{0};
+
+      //! Time since the pool was opened
+      std::chrono::nanoseconds elapsed{0};
+
+      //! @return Fraction of time the readers were leased out (0 to 1)
+      [[nodiscard]] double reader_utilization() const noexcept;
+
+      //! @return Fraction of time the writer was leased out (0 to 1)
+      [[nodiscard]] double writer_utilization() const noexcept;
+   };
+
+   //! A connection, borrowed from the pool. The connection is returned to the pool once the lease is destroyed.
+   //! Leases should not outlive the pool they were obtained from.
+   class SQLITE_BURRITO_EXPORT lease {
+   public:
+      lease() = default;
+
+      lease(const lease &) = delete;
+      lease(lease &&other) noexcept;
+
+      ~lease();
+
+   public:
+      lease &operator=(const lease &) = delete;
+      lease &operator=(lease &&other) noexcept;
+
+   public:
+      [[nodiscard]] connection &operator*() const noexcept { return *con_; }
+      [[nodiscard]] connection *operator->() const noexcept { return con_; }
+
+      [[nodiscard]] explicit operator bool() const noexcept { return con_ != nullptr; }
+
+      //! @return true if the leased connection is the writer
+      [[nodiscard]] bool is_writer() const noexcept { return writer_; }
+
+      //! Return the connection to the pool before the lease is destroyed
+      void release() noexcept;
+
+   private:
+      friend class connection_pool;
+
+      lease(connection_pool *pool, connection *con, bool writer) noexcept;
+
+   private:
+      connection_pool *pool_{nullptr};
+      connection *con_{nullptr};
+      bool writer_{false};
+      std::chrono::steady_clock::time_point since_{};
+   };
+
+   //! Write function type, errors reported via `ec` roll the write transaction back
+   using write_funct_t = std::function<void(connection &con, std::error_code &ec)>;
+
+public:
+   connection_pool();
+   explicit connection_pool(options opts);
+
+   connection_pool(const connection_pool &) = delete;
+   connection_pool(connection_pool &&) = delete;
+
+   ~connection_pool();
+
+public:
+   connection_pool &operator=(const connection_pool &) = delete;
+   connection_pool &operator=(connection_pool &&) = delete;
+
+public:
+   /**
+    * Open the writer, and then all the reader connections.
+    * The writer creates the database file if it doesn't exist yet. In-memory databases cannot be shared between
+    * connections, so the path should either point to a file, or be a shared cache URI.
+    * @note Should not be called while there are outstanding leases.
+    */
+   void open(std::string_view path);
+   void open(std::string_view path, std::error_code &ec) noexcept;
+
+   //! Get a read-only connection, waiting until one is available
+   [[nodiscard]] lease reader();
+
+   //! Same as above, but gives up after the timeout, reporting `std::errc::timed_out`
+   [[nodiscard]] lease reader(std::chrono::milliseconds timeout, std::error_code &ec);
+
+   //! Get the writer connection, waiting until it is available
+   [[nodiscard]] lease writer();
+
+   //! Same as above, but gives up after the timeout, reporting `std::errc::timed_out`
+   [[nodiscard]] lease writer(std::chrono::milliseconds timeout, std::error_code &ec);
+
+   /**
+    * Execute the function inside an immediate transaction on the writer connection.
+    * The transaction is committed if the function succeeds, and rolled back otherwise.
+    */
+   void write(const write_funct_t &func);
+   void write(const write_funct_t &func, std::error_code &ec);
+
+   [[nodiscard]] statistics stats() const noexcept;
+
+private:
+   void give_back(lease &lease) noexcept;
+
+private:
+   options options_;
+
+   //! Same Pimpl reasoning as in the statement class
+   struct impl;
+   impl *impl_;
+};
+
+} // namespace sqlite_burrito
+
+#endif // INCLUDE_SQLITE_BURRITO_CONNECTION_POOL_H
@@ -0,0 +1,244 @@
+/**
+ * @file   coroutines.h
+ */
+#ifndef INCLUDE_SQLITE_BURRITO_COROUTINES_H
+#define INCLUDE_SQLITE_BURRITO_COROUTINES_H
+
+#if !defined(__cpp_impl_coroutine)
+#error "The coroutine interface requires C++20, link against the SQLiteBurrito::coroutines target"
+#endif
+
+#include <sqlite-burrito/async_connection.h>
+#include <sqlite-burrito/column_view.h>
+#include <sqlite-burrito/statement.h>
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace sqlite_burrito {
+
+//! Resumes a coroutine, once its database operation is done (e.g. by posting it into an event loop)
+using resume_funct_t = std::function<void(std::coroutine_handle<>)>;
+
+/**
+ * Awaitable execution of a function on the `async_connection` worker thread.
+ * Awaiting suspends the coroutine, until the function is done. The function result is returned from the `co_await`
+ * expression, exceptions are re-thrown there (including the ones from a stopped connection).
+ */
+template <typename Func>
+class [[nodiscard]] job_awaitable {
+public:
+   using result_t = std::invoke_result_t<Func &, connection &>;
+
+public:
+   job_awaitable(async_connection &db, Func func, resume_funct_t resume)
+      : db_{&db}
+      , func_{std::move(func)}
+      , resume_{std::move(resume)} {
+      // Nothing to do here
+   }
+
+public:
+   [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+   bool await_suspend(std::coroutine_handle<> handle) {
+      try {
+         db_->post([this, handle](connection &con) {
+            try {
+               if constexpr (std::is_void_v<result_t>) {
+                  func_(con);
+                  result_.emplace();
+               } else {
+                  result_.emplace(func_(con));
+               }
+            } catch (...) {
+               error_ = std::current_exception();
+            }
+
+            // The coroutine might be done by the time the resumption returns, along with this awaitable
+            auto resume = resume_;
+            if (resume) {
+               resume(handle);
+            } else {
+               handle.resume();
+            }
+         });
+      } catch (...) {
+         // Nothing was posted, resume right away
+         error_ = std::current_exception();
+         return false;
+      }
+
+      // The job might already be done at this point, the members should not be accessed anymore
+      return true;
+   }
+
+   result_t await_resume() {
+      if (error_) {
+         std::rethrow_exception(error_);
+      }
+
+      if constexpr (!std::is_void_v<result_t>) {
+         return std::move(*result_);
+      }
+   }
+
+private:
+   using storage_t = std::conditional_t<std::is_void_v<result_t>, std::monostate, result_t>;
+
+   async_connection *db_;
+   Func func_;
+   resume_funct_t resume_;
+
+   std::optional<storage_t> result_{};
+   std::exception_ptr error_{};
+};
+
+/**
+ * Result rows of a statement, fetched in batches: each `next()` call steps through up to `batch_size` rows on the
+ * worker thread, so that the per-row overhead of switching the threads is amortized.
+ * Rows are decoded the same way as with `statement::rows`, the column types should own their data (e.g.
+ * `std::string` rather than `std::string_view` or `text_view`), because the rows outlive the statement step.
+ */
+template <typename... Ts>
+class row_batches {
+   template <typename T>
+   static constexpr bool is_view_v = std::is_same_v<T, std::string_view> || std::is_same_v<T, text_view> ||
+                                     std::is_same_v<T, blob_view>;
+
+public:
+   static_assert((!is_view_v<std::remove_cv_t<Ts>> && ...), "Batched rows cannot reference SQLite buffers");
+
+   using row_t = std::tuple<Ts...>;
+   using batch_t = std::vector<row_t>;
+
+public:
+   row_batches(async_connection &db, statement &stmt, std::size_t batch_size, resume_funct_t resume)
+      : db_{&db}
+      , stmt_{&stmt}
+      , batch_size_{batch_size ? batch_size : 1}
+      , resume_{std::move(resume)} {
+      // Nothing to do here
+   }
+
+public:
+   //! @return Awaitable for the next batch of rows (empty once all rows are fetched)
+   auto next() {
+      return job_awaitable{*db_,
+                           [this](connection &) {
+                              batch_t batch;
+                              if (done_) {
+                                 return batch;
+                              }
+
+                              batch.reserve(batch_size_);
+                              while (batch.size() < batch_size_) {
+                                 if (!stmt_->step()) {
+                                    done_ = true;
+                                    break;
+                                 }
+
+                                 row_t row;
+                                 stmt_->get_row(row);
+                                 batch.push_back(std::move(row));
+                              }
+                              return batch;
+                           },
+                           resume_};
+   }
+
+   //! @return true if all rows have been fetched
+   [[nodiscard]] bool done() const noexcept { return done_; }
+
+private:
+   async_connection *db_;
+   statement *stmt_;
+   std::size_t batch_size_;
+   resume_funct_t resume_;
+
+   //! Only accessed from the jobs, or after awaiting them
+   bool done_{false};
+};
+
+/**
+ * Coroutine interface to an `async_connection`. The awaitables can be used from any coroutine type, the library
+ * doesn't provide one: `task<void>` below stands for the caller's own task type (or one from a coroutine library).
+ *
+ * @code
+ * task<void> handle_request(coroutine_connection db) {
+ *    co_await db.execute("INSERT INTO visits(ts) VALUES (unixepoch());");
+ *
+ *    auto stmt = co_await db.prepare("SELECT id, name FROM users;");
+ *    auto rows = db.rows<std::int64_t, std::string>(*stmt);
+ *    for (auto batch = co_await rows.next(); !batch.empty(); batch = co_await rows.next()) {
+ *       ...
+ *    }
+ * }
+ * @endcode
+ *
+ * By default, coroutines are resumed on the worker thread, which keeps the database busy until the coroutine is
+ * suspended again. A resume function can be used to move the coroutines back into an event loop instead.
+ * Statements are bound to the worker, and should only be used via the jobs (or the `execute` and `rows` helpers).
+ */
+class coroutine_connection {
+public:
+   explicit coroutine_connection(async_connection &db, resume_funct_t resume = {})
+      : db_{&db}
+      , resume_{std::move(resume)} {
+      // Nothing to do here
+   }
+
+public:
+   //! Execute a function on the worker thread, see `async_connection::submit`
+   template <typename Func>
+   auto submit(Func &&func) const {
+      return job_awaitable<std::decay_t<Func>>{*db_, std::forward<Func>(func), resume_};
+   }
+
+   //! Execute one or more SQL statements (see `statement::execute`)
+   auto execute(std::string_view sql) const {
+      return submit([sql = std::string{sql}](connection &con) { statement::execute(con, sql); });
+   }
+
+   //! Execute a prepared statement
+   //! @return Number of rows modified by the statement
+   auto execute(statement &stmt) const {
+      return submit([&stmt](connection &) { return stmt.execute(); });
+   }
+
+   //! Prepare a statement on the worker connection (statements are not relocatable, hence the pointer)
+   auto prepare(std::string_view sql) const {
+      return submit([sql = std::string{sql}](connection &con) {
+         auto result = std::make_unique<statement>(con);
+         result->prepare(sql);
+         return result;
+      });
+   }
+
+   //! Fetch the statement result rows in batches, the statement should be kept alive in the meantime
+   template <typename... Ts>
+   [[nodiscard]] row_batches<Ts...> rows(statement &stmt, std::size_t batch_size = 64) const {
+      return row_batches<Ts...>{*db_, stmt, batch_size, resume_};
+   }
+
+   [[nodiscard]] async_connection &executor() const noexcept { return *db_; }
+
+private:
+   async_connection *db_;
+   resume_funct_t resume_;
+};
+
+} // namespace sqlite_burrito
+
+#endif // INCLUDE_SQLITE_BURRITO_COROUTINES_H
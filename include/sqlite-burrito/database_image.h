@@ -0,0 +1,105 @@
+/**
+ * @file   database_image.h
+ */
+#ifndef INCLUDE_SQLITE_BURRITO_DATABASE_IMAGE_H
+#define INCLUDE_SQLITE_BURRITO_DATABASE_IMAGE_H
+
+#include <sqlite3.h>
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+namespace sqlite_burrito {
+
+//! Serialized database (the same bytes, as the database would have on disk), see `connection::serialize`.
+//! The memory is allocated with the SQLite's allocator, so the ownership can be transferred to SQLite without copying.
+class database_image {
+public:
+   database_image() = default;
+
+   database_image(const database_image &) = delete;
+   database_image(database_image &&other) noexcept
+      : data_{other.data_}
+      , size_{other.size_} {
+      other.data_ = nullptr;
+      other.size_ = 0;
+   }
+
+   ~database_image() { ::sqlite3_free(data_); }
+
+public:
+   database_image &operator=(const database_image &) = delete;
+   database_image &operator=(database_image &&other) noexcept {
+      if (this != &other) {
+         ::sqlite3_free(data_);
+
+         data_ = other.data_;
+         size_ = other.size_;
+
+         other.data_ = nullptr;
+         other.size_ = 0;
+      }
+      return *this;
+   }
+
+public:
+   /**
+    * Take the ownership of a buffer, allocated with `sqlite3_malloc64`.
+    * @param data Buffer.
+    * @param size Buffer size in bytes.
+    */
+   static database_image adopt(unsigned char *data, std::size_t size) noexcept {
+      database_image result;
+      result.data_ = data;
+      result.size_ = data ? size : 0;
+      return result;
+   }
+
+   /**
+    * Allocate an uninitialized image, e.g. to read a database file into it with a single sequential read.
+    * @throws std::bad_alloc if there is not enough memory.
+    */
+   static database_image allocate(std::size_t size) {
+      auto buffer = static_cast<unsigned char *>(::sqlite3_malloc64(static_cast<sqlite3_uint64>(size ? size : 1)));
+      if (!buffer) {
+         throw std::bad_alloc();
+      }
+
+      return adopt(buffer, size);
+   }
+
+   /**
+    * Copy a database image (e.g. received from another process).
+    * @throws std::bad_alloc if there is not enough memory.
+    */
+   static database_image copy_of(const void *data, std::size_t size) {
+      auto result = allocate(size);
+      if (size > 0) {
+         std::memcpy(result.data_, data, size);
+      }
+      return result;
+   }
+
+   [[nodiscard]] const unsigned char *data() const noexcept { return data_; }
+   [[nodiscard]] unsigned char *data() noexcept { return data_; }
+
+   [[nodiscard]] std::size_t size() const noexcept { return size_; }
+   [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+   //! Give up the buffer ownership, the buffer should be released with `sqlite3_free`
+   [[nodiscard]] unsigned char *release() noexcept {
+      auto result = data_;
+      data_ = nullptr;
+      size_ = 0;
+      return result;
+   }
+
+private:
+   unsigned char *data_{nullptr};
+   std::size_t size_{0};
+};
+
+} // namespace sqlite_burrito
+
+#endif // INCLUDE_SQLITE_BURRITO_DATABASE_IMAGE_H
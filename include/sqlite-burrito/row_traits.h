@@ -0,0 +1,56 @@
+/**
+ * @file   row_traits.h
+ */
+#ifndef INCLUDE_SQLITE_BURRITO_ROW_TRAITS_H
+#define INCLUDE_SQLITE_BURRITO_ROW_TRAITS_H
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+namespace sqlite_burrito {
+
+/**
+ * Mapping between a structure and statement columns/parameters.
+ * Specialize this template, listing the structure members in the column order, to be able to bind and get whole
+ * structures via `statement::bind_row` and `statement::get_row`. For example:
+ *
+ * @code
+ * struct entry {
+ *    int first;
+ *    std::optional<std::string> second;
+ * };
+ *
+ * template <>
+ * struct sqlite_burrito::row_traits<entry> {
+ *    static constexpr auto columns = std::make_tuple(&entry::first, &entry::second);
+ * };
+ * @endcode
+ *
+ * Member `i` is bound to the parameter index `i + 1`, and is read from the column index `i`.
+ */
+template <typename T>
+struct row_traits;
+
+namespace detail {
+
+template <typename T, typename = void>
+struct is_mapped_row : std::false_type {};
+
+template <typename T>
+struct is_mapped_row<T, std::void_t<decltype(row_traits<T>::columns)>> : std::true_type {};
+
+} // namespace detail
+
+//! true if the row traits are specialized for the type T
+template <typename T>
+inline constexpr bool is_mapped_row_v = detail::is_mapped_row<T>::value;
+
+//! Number of mapped members
+template <typename T>
+inline constexpr std::size_t mapped_column_count_v =
+    std::tuple_size_v<std::remove_cv_t<std::remove_reference_t<decltype(row_traits<T>::columns)>>>;
+
+} // namespace sqlite_burrito
+
+#endif // INCLUDE_SQLITE_BURRITO_ROW_TRAITS_H
@@ -0,0 +1,216 @@
+/**
+ * @file   sql_text.h
+ */
+#ifndef INCLUDE_SQLITE_BURRITO_SQL_TEXT_H
+#define INCLUDE_SQLITE_BURRITO_SQL_TEXT_H
+
+#include <sqlite-burrito/statement.h>
+
+#include <cstddef>
+#include <string_view>
+#include <system_error>
+
+namespace sqlite_burrito {
+
+/**
+ * SQL statement text, with the parameters parsed at compile time.
+ * Parameter indices are resolved using the same rules as SQLite does (`?`, `?NNN`, `:name`, `@name` and `$name`),
+ * so that the named parameters can be bound without any runtime lookups. Resolving an unknown name in a constant
+ * expression is a compile error. For example:
+ *
+ * @code
+ * constexpr sql_text insert_sql{"INSERT INTO test(first, second) VALUES (:pfirst, :psecond);"};
+ * constexpr auto pfirst = insert_sql.param(":pfirst");
+ *
+ * statement stmt{con};
+ * stmt.prepare(insert_sql);
+ * stmt.bind(pfirst, 42);
+ * @endcode
+ *
+ * @note Only the first SQL statement in the text is considered, same as in `statement::prepare`.
+ */
+class sql_text {
+public:
+   template <std::size_t N>
+   constexpr sql_text(const char (&text)[N]) noexcept
+      : text_{text, N - 1} {
+      // Nothing to do here
+   }
+
+   constexpr explicit sql_text(std::string_view text) noexcept
+      : text_{text} {
+      // Nothing to do here
+   }
+
+public:
+   [[nodiscard]] constexpr std::string_view text() const noexcept { return text_; }
+   constexpr operator std::string_view() const noexcept { return text_; }
+
+   //! @return The largest parameter index (same as `sqlite3_bind_parameter_count`)
+   [[nodiscard]] constexpr int parameter_count() const noexcept { return resolve({}); }
+
+   //! @return true if there is a parameter with the specified name (including the prefix)
+   [[nodiscard]] constexpr bool has_param(std::string_view name) const noexcept { return resolve(name) > 0; }
+
+   /**
+    * Resolve a parameter index by its name.
+    * @param name Parameter name, including the prefix (e.g. ":pfirst")
+    * @return Parameter handle, usable with `statement::bind`
+    * @throws std::system_error with `std::errc::invalid_argument` for unknown names (same as the name-based binds).
+    */
+   [[nodiscard]] constexpr statement::parameter_handle param(std::string_view name) const {
+      const auto index = resolve(name);
+      if (index <= 0) {
+         // Results in a compile error when evaluated in a constant expression
+         throw std::system_error(std::make_error_code(std::errc::invalid_argument));
+      }
+      return statement::parameter_handle{index};
+   }
+
+private:
+   static constexpr bool is_name_char(char ch) noexcept {
+      return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_' ||
+             static_cast<unsigned char>(ch) >= 0x80;
+   }
+
+   static constexpr bool is_digit(char ch) noexcept { return ch >= '0' && ch <= '9'; }
+
+   //! Skip to the end of a quoted string, identifier, or a comment starting at `pos`
+   //! @return Position after the skipped part, or `pos` if there is nothing to skip
+   [[nodiscard]] constexpr std::size_t skip(std::size_t pos) const noexcept {
+      const auto ch = text_[pos];
+      const auto size = text_.size();
+
+      if (ch == '\'' || ch == '"' || ch == '`' || ch == '[') {
+         const char closing = (ch == '[') ? ']' : ch;
+         for (auto i = pos + 1; i < size; ++i) {
+            if (text_[i] == closing) {
+               return i + 1;
+            }
+         }
+         return size;
+      }
+
+      if (ch == '-' && pos + 1 < size && text_[pos + 1] == '-') {
+         for (auto i = pos + 2; i < size; ++i) {
+            if (text_[i] == '\n') {
+               return i + 1;
+            }
+         }
+         return size;
+      }
+
+      if (ch == '/' && pos + 1 < size && text_[pos + 1] == '*') {
+         for (auto i = pos + 2; i + 1 < size; ++i) {
+            if (text_[i] == '*' && text_[i + 1] == '/') {
+               return i + 2;
+            }
+         }
+         return size;
+      }
+
+      return pos;
+   }
+
+   //! Find the next parameter, starting at `pos`
+   //! @return Position after the parameter, or npos if there are no more parameters
+   [[nodiscard]] constexpr std::size_t next_param(std::size_t pos, std::string_view &param) const noexcept {
+      const auto size = text_.size();
+      while (pos < size) {
+         const auto skipped = skip(pos);
+         if (skipped != pos) {
+            pos = skipped;
+            continue;
+         }
+
+         const auto ch = text_[pos];
+         if (ch == ';') {
+            // End of the first statement
+            break;
+         }
+
+         auto end = pos + 1;
+         if (ch == '?') {
+            while (end < size && is_digit(text_[end])) {
+               ++end;
+            }
+         } else if (ch == ':' || ch == '@' || ch == '$') {
+            while (end < size && is_name_char(text_[end])) {
+               ++end;
+            }
+
+            if (end == pos + 1) {
+               // Just a lone prefix character
+               pos = end;
+               continue;
+            }
+         } else {
+            ++pos;
+            continue;
+         }
+
+         param = text_.substr(pos, end - pos);
+         return end;
+      }
+
+      return std::string_view::npos;
+   }
+
+   //! @return true if the named parameter was already used before `pos`
+   [[nodiscard]] constexpr bool seen_before(std::string_view name, std::size_t pos) const noexcept {
+      std::string_view param{};
+      for (auto it = next_param(0, param); it != std::string_view::npos && it < pos; it = next_param(it, param)) {
+         if (param == name) {
+            return true;
+         }
+      }
+      return false;
+   }
+
+   /**
+    * Replay the SQLite parameter numbering.
+    * @return Index of the `name` parameter (0 if there is no such parameter), or the largest index if `name` is empty
+    */
+   [[nodiscard]] constexpr int resolve(std::string_view name) const noexcept {
+      int max_index = 0;
+
+      std::string_view param{};
+      for (auto it = next_param(0, param); it != std::string_view::npos; it = next_param(it, param)) {
+         if (param == "?") {
+            ++max_index;
+            continue;
+         }
+
+         if (param[0] == '?') {
+            int index = 0;
+            for (auto ch : param.substr(1)) {
+               index = index * 10 + (ch - '0');
+            }
+            max_index = (index > max_index) ? index : max_index;
+
+            if (param == name) {
+               return index;
+            }
+            continue;
+         }
+
+         if (seen_before(param, it)) {
+            continue;
+         }
+
+         ++max_index;
+         if (param == name) {
+            return max_index;
+         }
+      }
+
+      return name.empty() ? max_index : 0;
+   }
+
+private:
+   std::string_view text_;
+};
+
+} // namespace sqlite_burrito
+
+#endif // INCLUDE_SQLITE_BURRITO_SQL_TEXT_H
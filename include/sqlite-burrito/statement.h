@@ -6,27 +6,34 @@
 #ifndef INCLUDE_SQLITE_BURRITO_STATEMENT_H
 #define INCLUDE_SQLITE_BURRITO_STATEMENT_H
 
+#include <sqlite-burrito/column_view.h>
 #include <sqlite-burrito/config.h>
 #include <sqlite-burrito/errors/sqlite.h>
 #include <sqlite-burrito/export.h>
 #include <sqlite-burrito/connection.h>
+#include <sqlite-burrito/row_traits.h>
 
 #include <array>
 #include <cstdint>
 #include <functional>
-#include <map>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace sqlite_burrito {
 
 class connection;
 
+template <typename... Ts>
+class row_range;
+
 class SQLITE_BURRITO_EXPORT statement {
 public:
    enum class prepare_flags : unsigned {
@@ -57,6 +64,14 @@ public:
 
    using optional_str_t = std::optional<std::string>;
 
+   //! Pre-resolved named parameter, see `param`
+   struct parameter_handle {
+      //! Parameter index, 0 if the parameter was not found
+      int index{0};
+
+      [[nodiscard]] explicit operator bool() const noexcept { return index > 0; }
+   };
+
 private:
    struct exec_callback_wrapper {
       explicit exec_callback_wrapper(exec_callback_t cb)
@@ -76,13 +91,13 @@ public:
    explicit statement(connection &conn, prepare_flags flags = prepare_flags::default_flags);
 
    statement(statement &) = delete;
-   statement(statement &&) = default;
+   statement(statement &&other) noexcept;
 
    ~statement();
 
 public:
    statement &operator=(statement &) = delete;
-   statement &operator=(statement &&) = default;
+   statement &operator=(statement &&other) noexcept;
 
 public:
    /**
@@ -102,6 +117,9 @@ public:
     */
    iterator_t prepare(std::string_view text, std::error_code &ec) noexcept;
 
+   //! @return false if nothing was prepared yet, or the SQL text contained no statement (e.g. only a comment)
+   [[nodiscard]] bool is_prepared() const noexcept { return stmt_ != nullptr; }
+
    [[nodiscard]] auto &native_handle() { return *stmt_; };
    [[nodiscard]] const auto &native_handle() const { return *stmt_; }
 
@@ -144,6 +162,12 @@ public:
    void reset();
    void reset(std::error_code &ec);
 
+   /**
+    * Reset all parameters to NULL, and release the values, bound by ownership.
+    */
+   void clear_bindings();
+   void clear_bindings(std::error_code &ec);
+
    /**
     * Execute the `step` call on a prepared statement.
     * Throws an exception in case of an error
@@ -153,10 +177,10 @@ public:
 
    /**
     * Execute the a `step` call on a prepared statement.
-    * @param ec Error code to store the step result in.
+    * @param ec Error code to store the step result in (SQLITE_ROW and SQLITE_DONE are not considered to be errors).
     * @return true if there is a row available (can be accessed via `get`)
     */
-   bool step(std::error_code ec);
+   bool step(std::error_code &ec);
 
    /**
     * @return Number of rows modified by this statement
@@ -174,6 +198,10 @@ public:
    void bind_null(int index);
    void bind_null(int index, std::error_code &ec);
 
+   //! Bind a zero-filled blob of the specified size, without allocating it (to be filled later with a `blob_stream`)
+   void bind_zeroblob(int index, std::size_t size);
+   void bind_zeroblob(int index, std::size_t size, std::error_code &ec);
+
    void bind(int index, const void *blob, std::size_t size);
    void bind(int index, const void *blob, std::size_t size, std::error_code &ec);
 
@@ -208,12 +236,54 @@ public:
    template <typename T>
    void bind(int index, const std::optional<T> &value, std::error_code &ec);
 
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Index-based zero-copy binds
+   ////////////////////////////////////////////////////////////////////////////////
+   /**
+    * Bind a text value without copying it (SQLITE_STATIC).
+    * The caller guarantees that the referenced buffer stays valid and unchanged until the parameter is successfully
+    * re-bound (with any value), the bindings are cleared with `clear_bindings`, or the statement is destroyed.
+    */
+   void bind_static(int index, std::string_view value);
+   void bind_static(int index, std::string_view value, std::error_code &ec);
+
+   /**
+    * Bind a blob value without copying it (SQLITE_STATIC).
+    * The caller guarantees that the referenced buffer stays valid and unchanged until the parameter is successfully
+    * re-bound (with any value), the bindings are cleared with `clear_bindings`, or the statement is destroyed.
+    */
+   void bind_static(int index, const void *blob, std::size_t size);
+   void bind_static(int index, const void *blob, std::size_t size, std::error_code &ec);
+
+   /**
+    * Bind a text value by taking ownership of it, instead of copying.
+    * SQLite only passes the data pointer to the destructor callbacks, so the moved value is kept alive by the
+    * statement itself. It is released once the same parameter is successfully re-bound (with any value, e.g. by
+    * `bind_null`), the bindings are cleared with `clear_bindings`, or the statement is destroyed. A failed bind keeps
+    * the previous value.
+    */
+   void bind_owned(int index, std::string &&value);
+   void bind_owned(int index, std::string &&value, std::error_code &ec);
+
+   /**
+    * Bind a blob value by taking ownership of it, instead of copying.
+    * @see bind_owned(int, std::string &&, std::error_code &)
+    */
+   template <typename T>
+   void bind_owned(int index, std::vector<T> &&value);
+
+   template <typename T>
+   void bind_owned(int index, std::vector<T> &&value, std::error_code &ec);
+
    ////////////////////////////////////////////////////////////////////////////////
    /// Name-based binds
    ////////////////////////////////////////////////////////////////////////////////
    void bind_null(std::string_view name);
    void bind_null(std::string_view name, std::error_code &ec);
 
+   void bind_zeroblob(std::string_view name, std::size_t size);
+   void bind_zeroblob(std::string_view name, std::size_t size, std::error_code &ec);
+
    template <typename T>
    void bind(std::string_view name, const T &value);
 
@@ -226,6 +296,79 @@ public:
    template <typename T, std::size_t N>
    void bind(std::string_view name, const T (&value)[N], std::error_code &ec);
 
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Handle-based binds
+   ////////////////////////////////////////////////////////////////////////////////
+   /**
+    * Resolve a named parameter once, so that it can be bound repeatedly without any name lookups.
+    * The handle stays valid until the statement is prepared again.
+    * @param name Parameter name, including the prefix (e.g. ":pfirst")
+    */
+   parameter_handle param(std::string_view name);
+   parameter_handle param(std::string_view name, std::error_code &ec);
+
+   void bind_null(parameter_handle param);
+   void bind_null(parameter_handle param, std::error_code &ec);
+
+   template <typename T>
+   void bind(parameter_handle param, const T &value);
+
+   template <typename T>
+   void bind(parameter_handle param, const T &value, std::error_code &ec);
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Name-based zero-copy binds
+   ////////////////////////////////////////////////////////////////////////////////
+   void bind_static(std::string_view name, std::string_view value);
+   void bind_static(std::string_view name, std::string_view value, std::error_code &ec);
+
+   void bind_static(std::string_view name, const void *blob, std::size_t size);
+   void bind_static(std::string_view name, const void *blob, std::size_t size, std::error_code &ec);
+
+   void bind_owned(std::string_view name, std::string &&value);
+   void bind_owned(std::string_view name, std::string &&value, std::error_code &ec);
+
+   template <typename T>
+   void bind_owned(std::string_view name, std::vector<T> &&value);
+
+   template <typename T>
+   void bind_owned(std::string_view name, std::vector<T> &&value, std::error_code &ec);
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Parameter pack binds
+   ////////////////////////////////////////////////////////////////////////////////
+   /**
+    * Bind all values positionally: the first value is bound to the parameter index 1, the second one to 2 and so on.
+    * Binding stops at the first error.
+    */
+   template <typename... Args>
+   void bind_all(const Args &...args);
+
+   template <typename... Args>
+   void bind_all(std::error_code &ec, const Args &...args);
+
+   /**
+    * Reset the statement, bind all values positionally (see `bind_all`) and execute it.
+    * @return Number of rows modified by this statement
+    */
+   template <typename... Args>
+   int execute_with(const Args &...args);
+
+   template <typename... Args>
+   int execute_with(std::error_code &ec, const Args &...args);
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Structure binds
+   ////////////////////////////////////////////////////////////////////////////////
+   /**
+    * Bind all structure members positionally, using the member order from the `row_traits<T>` specialization.
+    */
+   template <typename T>
+   void bind_row(const T &value);
+
+   template <typename T>
+   void bind_row(const T &value, std::error_code &ec);
+
    ////////////////////////////////////////////////////////////////////////////////
    /// Column information
    ////////////////////////////////////////////////////////////////////////////////
@@ -235,6 +378,14 @@ public:
    bool is_blob(int index);
    bool is_null(int index);
 
+   /**
+    * Find a result column index by the column name.
+    * The name lookup table is built on the first call after `prepare()`, and rebuilt automatically if SQLite
+    * re-prepares the statement after a schema change.
+    * @return Column index, or an empty optional if there is no such column.
+    */
+   std::optional<int> find_column(std::string_view name);
+
    ////////////////////////////////////////////////////////////////////////////////
    /// Index-based getters
    ////////////////////////////////////////////////////////////////////////////////
@@ -279,11 +430,126 @@ public:
    template <typename T>
    void get(int index, std::optional<T> &value, std::error_code &ec);
 
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Name-based getters
+   ////////////////////////////////////////////////////////////////////////////////
+   template <typename T>
+   void get(std::string_view column, T &value);
+
+   template <typename T>
+   void get(std::string_view column, T &value, std::error_code &ec);
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Index-based zero-copy getters
+   ////////////////////////////////////////////////////////////////////////////////
+   /**
+    * Get a text value without copying it. NULL values are returned as empty views.
+    * @param index Column index.
+    * @return View into the SQLite's row buffer, valid until the next `step()`, `reset()` or `prepare()` call.
+    */
+   text_view get_view(int index);
+   text_view get_view(int index, std::error_code &ec);
+
+   /**
+    * Get a blob value without copying it. NULL values are returned as empty views.
+    * @param index Column index.
+    * @return View into the SQLite's row buffer, valid until the next `step()`, `reset()` or `prepare()` call.
+    */
+   blob_view get_blob_view(int index);
+   blob_view get_blob_view(int index, std::error_code &ec);
+
+   void get(int index, std::string_view &value, std::error_code &ec);
+   void get(int index, text_view &value, std::error_code &ec);
+   void get(int index, blob_view &value, std::error_code &ec);
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Index-based unchecked getters
+   ////////////////////////////////////////////////////////////////////////////////
+   /**
+    * Get a numeric value without any error checking.
+    * The checked getters have to query the connection error each time a zero is read from a non-numeric column (to
+    * tell a real zero from a failed conversion), these ones never do. Intended for the hot loops, where the index is
+    * known to be valid. Out-of-range indices, NULLs and failed conversions are all read as zero.
+    * @param index Column index.
+    * @param value Target arithmetic value.
+    */
+   template <typename T>
+   void get_unchecked(int index, T &value) noexcept;
+
+   template <typename T>
+   [[nodiscard]] T get_unchecked(int index) noexcept;
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Typed row access
+   ////////////////////////////////////////////////////////////////////////////////
+   /**
+    * Get the current row as a tuple, column `i` is stored in the tuple element `i`.
+    */
+   template <typename... Ts>
+   void get_row(std::tuple<Ts...> &row);
+
+   template <typename... Ts>
+   void get_row(std::tuple<Ts...> &row, std::error_code &ec);
+
+   /**
+    * Get the current row into a structure, using the member order from the `row_traits<T>` specialization.
+    */
+   template <typename T, typename = std::enable_if_t<is_mapped_row_v<T>>>
+   void get_row(T &value);
+
+   template <typename T, typename = std::enable_if_t<is_mapped_row_v<T>>>
+   void get_row(T &value, std::error_code &ec);
+
+   /**
+    * Iterate over the remaining result rows, decoding column `i` into the tuple element `i`.
+    * Iteration starts with the next `step()` call, so the statement should be reset and bound beforehand. Errors are
+    * reported as exceptions.
+    * @note Views (e.g. `std::string_view`) are only valid until the iterator is advanced.
+    */
+   template <typename... Ts>
+   row_range<Ts...> rows();
+
+   /**
+    * Same as above, but errors stop the iteration, and are stored in `ec`.
+    * @param ec Error code, should outlive the range.
+    */
+   template <typename... Ts>
+   row_range<Ts...> rows(std::error_code &ec);
+
 private:
+   template <std::size_t... Idx, typename... Args>
+   void bind_indexed(std::error_code &ec, std::index_sequence<Idx...>, const Args &...args);
+
+   template <typename Tuple, std::size_t... Idx>
+   void get_row(Tuple &row, std::error_code &ec, std::index_sequence<Idx...>);
+
+   template <typename T, std::size_t... Idx>
+   void bind_mapped(const T &value, std::error_code &ec, std::index_sequence<Idx...>);
+
+   template <typename T, std::size_t... Idx>
+   void get_mapped(T &value, std::error_code &ec, std::index_sequence<Idx...>);
+
    void fill_parameters_map();
+   void clear_parameters_map() noexcept;
 
    std::optional<int> find_parameter_by_name(std::string_view name);
 
+   //! Keep an owned parameter value alive until the parameter is bound again, the bindings are cleared, or the
+   //! statement is destroyed. The value is released with the `deleter` function.
+   void keep_alive(int index, void *value, void (*deleter)(void *));
+
+   //! Release the owned value of a parameter, once it was successfully re-bound (`ec` being the bind result)
+   void release_owned(int index, const std::error_code &ec) noexcept;
+
+   //! Invalidate all column views, obtained so far
+   void invalidate_views() noexcept;
+
+   //! @return Row generation counter for the column views
+   const std::uint64_t *view_generation();
+
+   //! Finalize the statement, and release all resources
+   void destroy() noexcept;
+
 private:
    //! Database connection, this statement belongs to
    connection *connection_;
@@ -294,13 +560,37 @@ private:
    //! Native handle
    native_handle_t stmt_{nullptr};
 
-   //! Named parameters map
+   //! Current row generation, incremented each time the column values are invalidated (used by column views).
+   //! Allocated on the first view access, so that the views keep tracking the statement after it's moved.
+   std::uint64_t *generation_{nullptr};
+
+   //! Named parameters lookup table, sorted by the name hash.
+   //! Statements with up to `inline_parameter_count` named parameters are using the inline storage, only the larger ones
+   //! are allocating the table on the heap. The names themselves are not stored: SQLite releases them when the
+   //! statement is re-prepared (e.g. after a schema change), so the candidates are compared with the current ones.
+   struct parameter_slot {
+      std::uint32_t hash;
+      int index;
+      std::size_t length;
+   };
+
+   static constexpr std::size_t inline_parameter_count = 8;
+   parameter_slot inline_parameters_[inline_parameter_count]{};
+   parameter_slot *heap_parameters_{nullptr};
+   std::size_t parameter_count_{0};
+   bool parameters_filled_{false};
+
+   //! Result column names lookup table
    //! The Pimpl (Pointer to IMPLementation) idiom is used here to hide implementation details,
    //! such as STL types without a DLL interface, from the public class interface. This avoids
    //! MSVC warning C4251 and ensures ABI stability across DLL boundaries.
-   //! We are not using a unique_ptr here because MSVC requires the parameter_map type to be completely defined.
-   struct parameter_map;
-   parameter_map *parameters_{};
+   //! We are not using a unique_ptr here because MSVC requires the column_map type to be completely defined.
+   struct column_map;
+   column_map *columns_{};
+
+   //! Values, bound by ownership (same Pimpl reasoning as above)
+   struct owned_values;
+   owned_values *owned_{};
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -354,6 +644,33 @@ void statement::bind(int index, const std::optional<T> &value, std::error_code &
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Index-based zero-copy binds
+////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+void statement::bind_owned(int index, std::vector<T> &&value) {
+   std::error_code ec;
+   bind_owned(index, std::move(value), ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+template <typename T>
+void statement::bind_owned(int index, std::vector<T> &&value, std::error_code &ec) {
+   static_assert(std::is_pod_v<T>, "POD type expected");
+
+   auto owned = std::make_unique<std::vector<T>>(std::move(value));
+
+   // On failures SQLite is still referencing the previous value, so it's only replaced after a successful bind
+   bind_static(index, owned->data(), sizeof(T) * owned->size(), ec);
+   if (ec) {
+      return;
+   }
+
+   keep_alive(index, owned.release(), [](void *ptr) { delete static_cast<std::vector<T> *>(ptr); });
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Name-based binds
 ////////////////////////////////////////////////////////////////////////////////
@@ -397,6 +714,120 @@ void statement::bind(std::string_view name, const T (&value)[N], std::error_code
    bind(*optional_idx, value, ec);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Handle-based binds
+////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+void statement::bind(parameter_handle param, const T &value) {
+   std::error_code ec;
+   bind(param, value, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+template <typename T>
+void statement::bind(parameter_handle param, const T &value, std::error_code &ec) {
+   bind(param.index, value, ec);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Name-based zero-copy binds
+////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+void statement::bind_owned(std::string_view name, std::vector<T> &&value) {
+   std::error_code ec;
+   bind_owned(name, std::move(value), ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+template <typename T>
+void statement::bind_owned(std::string_view name, std::vector<T> &&value, std::error_code &ec) {
+   auto optional_idx = find_parameter_by_name(name);
+   if (!optional_idx) {
+      ec = std::make_error_code(std::errc::invalid_argument);
+      return;
+   }
+
+   bind_owned(*optional_idx, std::move(value), ec);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Parameter pack binds
+////////////////////////////////////////////////////////////////////////////////
+template <typename... Args>
+void statement::bind_all(const Args &...args) {
+   std::error_code ec;
+   bind_all(ec, args...);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+template <typename... Args>
+void statement::bind_all(std::error_code &ec, const Args &...args) {
+   ec.clear();
+   bind_indexed(ec, std::index_sequence_for<Args...>{}, args...);
+}
+
+template <typename... Args>
+int statement::execute_with(const Args &...args) {
+   std::error_code ec;
+   auto result = execute_with(ec, args...);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+   return result;
+}
+
+template <typename... Args>
+int statement::execute_with(std::error_code &ec, const Args &...args) {
+   reset(ec);
+   if (ec) {
+      return 0;
+   }
+
+   bind_indexed(ec, std::index_sequence_for<Args...>{}, args...);
+   if (ec) {
+      return 0;
+   }
+
+   return execute(ec);
+}
+
+template <std::size_t... Idx, typename... Args>
+void statement::bind_indexed(std::error_code &ec, std::index_sequence<Idx...>, const Args &...args) {
+   // Stop at the first failed bind
+   ((ec ? void() : bind(static_cast<int>(Idx + 1), args, ec)), ...);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Structure binds
+////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+void statement::bind_row(const T &value) {
+   std::error_code ec;
+   bind_row(value, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+template <typename T>
+void statement::bind_row(const T &value, std::error_code &ec) {
+   static_assert(is_mapped_row_v<T>, "row_traits<T> specialization expected");
+   ec.clear();
+   bind_mapped(value, ec, std::make_index_sequence<mapped_column_count_v<T>>{});
+}
+
+template <typename T, std::size_t... Idx>
+void statement::bind_mapped(const T &value, std::error_code &ec, std::index_sequence<Idx...>) {
+   constexpr auto &columns = row_traits<T>::columns;
+   bind_indexed(ec, std::index_sequence<Idx...>{}, value.*std::get<Idx>(columns)...);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Index-based getters
 ////////////////////////////////////////////////////////////////////////////////
@@ -522,6 +953,192 @@ void statement::get(int index, std::optional<T> &value, std::error_code &ec) {
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Index-based unchecked getters
+////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+void statement::get_unchecked(int index, T &value) noexcept {
+   static_assert(std::is_arithmetic_v<T>, "Only arithmetic values are supported");
+
+   if constexpr (std::is_same_v<T, bool>) {
+      value = (::sqlite3_column_int(stmt_, index) != 0);
+   } else if constexpr (std::is_floating_point_v<T>) {
+      value = static_cast<T>(::sqlite3_column_double(stmt_, index));
+   } else if constexpr (sizeof(T) <= sizeof(int)) {
+      value = static_cast<T>(::sqlite3_column_int(stmt_, index));
+   } else {
+      value = static_cast<T>(::sqlite3_column_int64(stmt_, index));
+   }
+}
+
+template <typename T>
+T statement::get_unchecked(int index) noexcept {
+   T result;
+   get_unchecked(index, result);
+   return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Name-based getters
+////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+void statement::get(std::string_view column, T &value) {
+   std::error_code ec;
+   get(column, value, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+template <typename T>
+void statement::get(std::string_view column, T &value, std::error_code &ec) {
+   auto optional_idx = find_column(column);
+   if (!optional_idx) {
+      ec = std::make_error_code(std::errc::invalid_argument);
+      return;
+   }
+
+   get(*optional_idx, value, ec);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Typed row access
+////////////////////////////////////////////////////////////////////////////////
+template <typename... Ts>
+void statement::get_row(std::tuple<Ts...> &row) {
+   std::error_code ec;
+   get_row(row, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+template <typename... Ts>
+void statement::get_row(std::tuple<Ts...> &row, std::error_code &ec) {
+   ec.clear();
+   get_row(row, ec, std::index_sequence_for<Ts...>{});
+}
+
+template <typename Tuple, std::size_t... Idx>
+void statement::get_row(Tuple &row, std::error_code &ec, std::index_sequence<Idx...>) {
+   // Stop at the first failed column
+   ((ec ? void() : get(static_cast<int>(Idx), std::get<Idx>(row), ec)), ...);
+}
+
+template <typename T, typename>
+void statement::get_row(T &value) {
+   std::error_code ec;
+   get_row(value, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+template <typename T, typename>
+void statement::get_row(T &value, std::error_code &ec) {
+   ec.clear();
+   get_mapped(value, ec, std::make_index_sequence<mapped_column_count_v<T>>{});
+}
+
+template <typename T, std::size_t... Idx>
+void statement::get_mapped(T &value, std::error_code &ec, std::index_sequence<Idx...>) {
+   constexpr auto &columns = row_traits<T>::columns;
+
+   // Stop at the first failed column
+   ((ec ? void() : get(static_cast<int>(Idx), value.*std::get<Idx>(columns), ec)), ...);
+}
+
+template <typename... Ts>
+row_range<Ts...> statement::rows() {
+   return row_range<Ts...>{*this, nullptr};
+}
+
+template <typename... Ts>
+row_range<Ts...> statement::rows(std::error_code &ec) {
+   return row_range<Ts...>{*this, &ec};
+}
+
+//! Single-pass range over the statement result rows, see `statement::rows`
+template <typename... Ts>
+class row_range {
+public:
+   using value_type = std::tuple<Ts...>;
+
+   class iterator {
+   public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = row_range::value_type;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const value_type *;
+      using reference = const value_type &;
+
+   public:
+      iterator() = default;
+
+      explicit iterator(row_range *range) noexcept
+         : range_{range} {
+         // Nothing to do here
+      }
+
+   public:
+      reference operator*() const noexcept { return range_->row_; }
+      pointer operator->() const noexcept { return &range_->row_; }
+
+      iterator &operator++() {
+         if (!range_->advance()) {
+            range_ = nullptr;
+         }
+         return *this;
+      }
+
+      void operator++(int) { ++*this; }
+
+      bool operator==(const iterator &other) const noexcept { return range_ == other.range_; }
+      bool operator!=(const iterator &other) const noexcept { return range_ != other.range_; }
+
+   private:
+      row_range *range_{nullptr};
+   };
+
+public:
+   row_range(statement &stmt, std::error_code *ec) noexcept
+      : stmt_{&stmt}
+      , ec_{ec} {
+      // Nothing to do here
+   }
+
+public:
+   iterator begin() { return advance() ? iterator{this} : end(); }
+   iterator end() noexcept { return iterator{}; }
+
+private:
+   //! Step to the next row, and decode it
+   //! @return true if a row is available
+   bool advance() {
+      std::error_code ec;
+      bool have_row = stmt_->step(ec);
+      if (have_row && !ec) {
+         stmt_->get_row(row_, ec);
+      }
+
+      if (!ec) {
+         return have_row;
+      }
+
+      if (!ec_) {
+         throw std::system_error(ec);
+      }
+
+      *ec_ = ec;
+      return false;
+   }
+
+private:
+   statement *stmt_;
+   std::error_code *ec_;
+   value_type row_{};
+};
+
 } // namespace sqlite_burrito
 
 SQLITE_BURRITO_EXPORT constexpr inline sqlite_burrito::statement::prepare_flags operator|(
@@ -0,0 +1,126 @@
+/**
+ * @file   statement_cache.h
+ */
+#ifndef INCLUDE_SQLITE_BURRITO_STATEMENT_CACHE_H
+#define INCLUDE_SQLITE_BURRITO_STATEMENT_CACHE_H
+
+#include <sqlite-burrito/export.h>
+#include <sqlite-burrito/statement.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <system_error>
+
+namespace sqlite_burrito {
+
+class connection;
+
+//! LRU cache of prepared statements, keyed by the SQL text.
+//! Idle statements are kept prepared (with the `persistent` flag), and handed out as leases. Returning a lease resets
+//! the statement and clears its bindings. Same as the connection itself, the cache is not thread-safe.
+class SQLITE_BURRITO_EXPORT statement_cache {
+public:
+   struct limits {
+      //! Maximal number of idle statements to keep (0 disables caching)
+      std::size_t max_statements{64};
+
+      //! Maximal memory, used by the idle statements (as reported by SQLITE_STMTSTATUS_MEMUSED), 0 means unlimited
+      std::size_t max_bytes{0};
+   };
+
+   struct statistics {
+      //! Number of acquisitions served from the cache
+      std::uint64_t hits{0};
+
+      //! Number of acquisitions, which required a new statement to be prepared
+      std::uint64_t misses{0};
+
+      //! Number of idle statements finalized because of the cache limits
+      std::uint64_t evictions{0};
+
+      //! Number of currently idle statements and the memory they are using
+      std::size_t size{0};
+      std::size_t bytes{0};
+   };
+
+   //! A statement, borrowed from the cache. The statement is returned to the cache once the lease is destroyed.
+   //! Leases should not outlive the cache (and thus the connection) they were obtained from.
+   class SQLITE_BURRITO_EXPORT lease {
+   public:
+      lease() = default;
+
+      lease(const lease &) = delete;
+      lease(lease &&other) noexcept;
+
+      ~lease();
+
+   public:
+      lease &operator=(const lease &) = delete;
+      lease &operator=(lease &&other) noexcept;
+
+   public:
+      [[nodiscard]] statement &operator*() const noexcept { return *stmt_; }
+      [[nodiscard]] statement *operator->() const noexcept { return stmt_; }
+
+      [[nodiscard]] explicit operator bool() const noexcept { return stmt_ != nullptr; }
+
+      //! Return the statement to the cache before the lease is destroyed
+      void release() noexcept;
+
+   private:
+      friend class statement_cache;
+
+      lease(statement_cache *cache, statement *stmt) noexcept;
+
+   private:
+      statement_cache *cache_{nullptr};
+      statement *stmt_{nullptr};
+   };
+
+public:
+   explicit statement_cache(connection &con);
+   statement_cache(connection &con, limits limits);
+
+   statement_cache(const statement_cache &) = delete;
+   statement_cache(statement_cache &&) = delete;
+
+   ~statement_cache();
+
+public:
+   statement_cache &operator=(const statement_cache &) = delete;
+   statement_cache &operator=(statement_cache &&) = delete;
+
+public:
+   /**
+    * Get a prepared statement for the SQL text, either from the cache, or by preparing a new one.
+    * Only the first SQL statement in `sql` is compiled.
+    */
+   lease acquire(std::string_view sql);
+   lease acquire(std::string_view sql, std::error_code &ec);
+
+   //! Finalize all idle statements
+   void clear() noexcept;
+
+   void set_limits(limits limits);
+   [[nodiscard]] limits get_limits() const noexcept;
+
+   [[nodiscard]] statistics stats() const noexcept;
+
+private:
+   void give_back(statement *stmt) noexcept;
+   void enforce_limits() noexcept;
+
+private:
+   //! Database connection, the statements belong to
+   connection *con_;
+
+   //! Same Pimpl reasoning as in the statement class
+   struct impl;
+   impl *impl_;
+};
+
+} // namespace sqlite_burrito
+
+#endif // INCLUDE_SQLITE_BURRITO_STATEMENT_CACHE_H
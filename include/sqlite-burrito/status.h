@@ -0,0 +1,51 @@
+/**
+ * @file   status.h
+ */
+#ifndef INCLUDE_SQLITE_BURRITO_STATUS_H
+#define INCLUDE_SQLITE_BURRITO_STATUS_H
+
+#include <sqlite-burrito/export.h>
+
+#include <cstdint>
+
+namespace sqlite_burrito {
+
+//! A single SQLite status value. Some values only have a meaningful current, or a high-water value.
+struct status_counter {
+   std::int64_t current{0};
+   std::int64_t highwater{0};
+};
+
+//! Process-wide SQLite memory statistics, see https://www.sqlite.org/c3ref/c_status_malloc_count.html
+struct global_statistics {
+   //! Memory, currently allocated by SQLite, in bytes
+   status_counter memory_used{};
+
+   //! Number of separate memory allocations
+   status_counter malloc_count{};
+
+   //! Largest memory allocation request, in bytes (high-water only)
+   status_counter malloc_size{};
+
+   //! Number of pages, used out of the page cache memory (configured with SQLITE_CONFIG_PAGECACHE)
+   status_counter pagecache_used{};
+
+   //! Page cache allocations, which did not fit into the page cache memory, and were served by the heap, in bytes
+   status_counter pagecache_overflow{};
+
+   //! Largest page cache allocation request, in bytes (high-water only)
+   status_counter pagecache_size{};
+
+   //! Deepest parser stack (high-water only, requires YYTRACKMAXSTACKDEPTH)
+   status_counter parser_stack{};
+};
+
+/**
+ * Get a snapshot of the process-wide SQLite memory statistics.
+ * @param reset_highwater Reset the high-water marks to the current values, after reading them.
+ */
+SQLITE_BURRITO_EXPORT global_statistics global_stats(bool reset_highwater = false) noexcept;
+
+} // namespace sqlite_burrito
+
+#endif // INCLUDE_SQLITE_BURRITO_STATUS_H
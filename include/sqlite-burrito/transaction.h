@@ -26,6 +26,14 @@ public:
    };
 
 public:
+   /**
+    * Begin a transaction.
+    * If the connection is already inside a transaction, a nested transaction is started instead, using an automatically
+    * named savepoint (the behavior parameter is ignored in this case). Committing a nested transaction releases the
+    * savepoint, rolling it back only reverts the changes made since the savepoint was created.
+    * @param con Database connection
+    * @param behavior Transaction behavior (only used for the outermost transaction)
+    */
    transaction(connection &con, behavior behavior = behavior::default_behavior);
 
    transaction(transaction &) = delete;
@@ -44,9 +52,21 @@ public:
    void rollback();
    void rollback(std::error_code &ec) noexcept;
 
+   //! @return true if this is a savepoint-based transaction, nested in another one
+   [[nodiscard]] bool is_nested() const noexcept { return savepoint_ != 0; }
+
+private:
+   void end(bool commit, std::error_code &ec) noexcept;
+
+   //! Update the connection savepoint depth after ending the transaction (`ec` being the result)
+   void update_savepoint_depth(int depth, const std::error_code &ec) noexcept;
+
 private:
    connection *con_;
 
+   //! Savepoint nesting depth, 0 for the outermost transactions
+   int savepoint_{0};
+
    bool committed_{false};
    bool rolled_back_{false};
 };
@@ -0,0 +1,148 @@
+/**
+ * @file   async_connection.cpp
+ */
+
+#include <sqlite-burrito/async_connection.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace sqlite_burrito;
+
+struct async_connection::impl {
+   //! Only accessed from the worker thread (and destroyed after it's joined)
+   connection con{};
+
+   mutable std::mutex mutex{};
+   std::condition_variable job_available{};
+   std::condition_variable space_available{};
+
+   std::deque<job_t> jobs{};
+   bool stopping{false};
+
+   std::thread worker{};
+
+   //! Kept separately, so that it's not affected by joining the worker
+   std::thread::id worker_id{};
+
+   void run() {
+      while (true) {
+         job_t job;
+         {
+            std::unique_lock lock{mutex};
+            job_available.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) {
+               // Stopping, and all the pending jobs are done
+               return;
+            }
+
+            job = std::move(jobs.front());
+            jobs.pop_front();
+         }
+         space_available.notify_one();
+
+         try {
+            job(con);
+         } catch (...) {
+            // There is nobody to report to, jobs should deliver their errors themselves
+         }
+      }
+   }
+
+   void enqueue(job_t &&job, std::size_t capacity, bool wait, std::error_code &ec) {
+      {
+         std::unique_lock lock{mutex};
+
+         // Blocking the worker on its own queue would never end
+         const auto bounded = (std::this_thread::get_id() != worker_id);
+         const auto has_space = [&] { return stopping || !bounded || jobs.size() < capacity; };
+
+         if (wait) {
+            space_available.wait(lock, has_space);
+         }
+
+         if (stopping) {
+            ec = std::make_error_code(std::errc::operation_canceled);
+            return;
+         }
+
+         if (!has_space()) {
+            ec = std::make_error_code(std::errc::resource_unavailable_try_again);
+            return;
+         }
+
+         jobs.push_back(std::move(job));
+      }
+      job_available.notify_one();
+   }
+};
+
+async_connection::async_connection()
+   : async_connection(options{}) {
+   // Nothing to do here
+}
+
+async_connection::async_connection(options opts)
+   : options_{opts}
+   , impl_{new impl()} {
+   if (options_.queue_capacity == 0) {
+      options_.queue_capacity = 1;
+   }
+
+   impl_->worker = std::thread([this] { impl_->run(); });
+   impl_->worker_id = impl_->worker.get_id();
+}
+
+async_connection::~async_connection() {
+   stop();
+   delete impl_;
+}
+
+std::future<void> async_connection::open(std::string_view filename) {
+   return submit([name = std::string{filename}](connection &con) { con.open(name); });
+}
+
+std::future<void> async_connection::open(std::string_view filename, const connection_options &options) {
+   return submit([name = std::string{filename}, options](connection &con) { con.open(name, options); });
+}
+
+void async_connection::stop() noexcept {
+   {
+      std::lock_guard lock{impl_->mutex};
+      impl_->stopping = true;
+   }
+   impl_->job_available.notify_all();
+   impl_->space_available.notify_all();
+
+   if (impl_->worker.joinable()) {
+      impl_->worker.join();
+   }
+}
+
+void async_connection::post(job_t job) {
+   std::error_code ec;
+   post(std::move(job), ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void async_connection::post(job_t job, std::error_code &ec) {
+   impl_->enqueue(std::move(job), options_.queue_capacity, true, ec);
+}
+
+void async_connection::try_post(job_t job, std::error_code &ec) {
+   impl_->enqueue(std::move(job), options_.queue_capacity, false, ec);
+}
+
+std::size_t async_connection::pending() const noexcept {
+   std::lock_guard lock{impl_->mutex};
+   return impl_->jobs.size();
+}
+
+bool async_connection::on_worker_thread() const noexcept {
+   return std::this_thread::get_id() == impl_->worker_id;
+}
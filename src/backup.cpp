@@ -0,0 +1,126 @@
+/**
+ * @file   backup.cpp
+ */
+
+#include <sqlite-burrito/backup.h>
+#include <sqlite-burrito/connection.h>
+#include <sqlite-burrito/errors/sqlite.h>
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+using namespace sqlite_burrito;
+
+namespace {
+
+//! Minimal delay before retrying a locked step, so that a zero step delay doesn't turn into a busy loop
+constexpr std::chrono::milliseconds min_busy_delay{1};
+
+} // namespace
+
+struct backup::impl {
+   options opts{};
+
+   std::atomic<bool> cancelled{false};
+
+   //! Progress as of the last step (read from other threads)
+   std::atomic<int> remaining{0};
+   std::atomic<int> total{0};
+};
+
+backup::backup(connection &source, connection &destination)
+   : backup(source, destination, options{}) {
+   // Nothing to do here
+}
+
+backup::backup(connection &source, connection &destination, options opts)
+   : source_{&source}
+   , destination_{&destination}
+   , impl_{new impl()} {
+   impl_->opts = opts;
+}
+
+backup::~backup() {
+   delete impl_;
+}
+
+void backup::run(const progress_funct_t &callback) {
+   std::error_code ec;
+   run(callback, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void backup::run(const progress_funct_t &callback, std::error_code &ec) {
+   auto handle = ::sqlite3_backup_init(&destination_->native_handle(), "main", &source_->native_handle(), "main");
+   if (!handle) {
+      // Initialization errors are stored in the destination connection
+      ec = destination_->last_error();
+      return;
+   }
+
+   const auto &opts = impl_->opts;
+   const auto pages_per_step = (opts.pages_per_step == 0) ? -1 : opts.pages_per_step;
+
+   int busy_retries = 0;
+   while (true) {
+      auto rc = ::sqlite3_backup_step(handle, pages_per_step);
+
+      impl_->remaining = ::sqlite3_backup_remaining(handle);
+      impl_->total = ::sqlite3_backup_pagecount(handle);
+
+      if (rc == SQLITE_DONE) {
+         break;
+      }
+
+      const bool locked = (rc == SQLITE_BUSY || rc == SQLITE_LOCKED);
+      if (rc != SQLITE_OK && !locked) {
+         ec = errors::make_error_code(rc);
+         break;
+      }
+
+      busy_retries = locked ? busy_retries + 1 : 0;
+      if (locked && opts.max_busy_retries > 0 && busy_retries > opts.max_busy_retries) {
+         ec = errors::make_error_code(rc);
+         break;
+      }
+
+      if (callback && !callback(get_progress())) {
+         impl_->cancelled = true;
+      }
+
+      if (impl_->cancelled) {
+         ec = std::make_error_code(std::errc::operation_canceled);
+         break;
+      }
+
+      const auto delay = locked ? std::max(opts.step_delay, min_busy_delay) : opts.step_delay;
+      if (delay.count() > 0) {
+         std::this_thread::sleep_for(delay);
+      }
+   }
+
+   // Finishing an incomplete backup releases the destination, without committing anything
+   auto rc = ::sqlite3_backup_finish(handle);
+   if (!ec) {
+      ec = errors::make_error_code(rc);
+   }
+
+   impl_->cancelled = false;
+
+   if (!ec && callback) {
+      callback(get_progress());
+   }
+}
+
+void backup::cancel() noexcept {
+   impl_->cancelled = true;
+}
+
+backup::progress backup::get_progress() const noexcept {
+   return progress{impl_->remaining, impl_->total};
+}
@@ -0,0 +1,229 @@
+/**
+ * @file   blob_stream.cpp
+ */
+
+#include <sqlite-burrito/blob_stream.h>
+#include <sqlite-burrito/connection.h>
+#include <sqlite-burrito/errors/sqlite.h>
+
+#include <algorithm>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace sqlite_burrito;
+
+blob_stream::blob_stream(connection &con)
+   : connection_{&con} {
+   // Nothing to do here
+}
+
+blob_stream::blob_stream(blob_stream &&other) noexcept
+   : connection_{other.connection_}
+   , blob_{other.blob_}
+   , size_{other.size_}
+   , position_{other.position_} {
+   other.blob_ = nullptr;
+   other.size_ = 0;
+   other.position_ = 0;
+}
+
+blob_stream::~blob_stream() {
+   close();
+}
+
+blob_stream &blob_stream::operator=(blob_stream &&other) noexcept {
+   if (this != &other) {
+      close();
+
+      connection_ = other.connection_;
+      blob_ = other.blob_;
+      size_ = other.size_;
+      position_ = other.position_;
+
+      other.blob_ = nullptr;
+      other.size_ = 0;
+      other.position_ = 0;
+   }
+   return *this;
+}
+
+void blob_stream::open(std::string_view table, std::string_view column, std::int64_t rowid, mode mode) {
+   std::error_code ec;
+   open(table, column, rowid, mode, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void blob_stream::open(std::string_view table,
+                       std::string_view column,
+                       std::int64_t rowid,
+                       mode mode,
+                       std::error_code &ec) noexcept {
+   close();
+
+   // Names have to be null-terminated
+   const std::string table_name{table};
+   const std::string column_name{column};
+
+   ec = errors::make_error_code(::sqlite3_blob_open(&connection_->native_handle(), "main", table_name.c_str(),
+                                                    column_name.c_str(), rowid, static_cast<int>(mode), &blob_));
+   if (ec) {
+      // A handle might still be allocated on errors
+      close();
+      return;
+   }
+
+   size_ = static_cast<std::size_t>(::sqlite3_blob_bytes(blob_));
+}
+
+void blob_stream::reopen(std::int64_t rowid) {
+   std::error_code ec;
+   reopen(rowid, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void blob_stream::reopen(std::int64_t rowid, std::error_code &ec) noexcept {
+   if (!blob_) {
+      ec = std::make_error_code(std::errc::bad_file_descriptor);
+      return;
+   }
+
+   position_ = 0;
+   ec = errors::make_error_code(::sqlite3_blob_reopen(blob_, rowid));
+   size_ = ec ? 0 : static_cast<std::size_t>(::sqlite3_blob_bytes(blob_));
+}
+
+void blob_stream::close() noexcept {
+   ::sqlite3_blob_close(blob_);
+   blob_ = nullptr;
+   size_ = 0;
+   position_ = 0;
+}
+
+void blob_stream::seek(std::size_t position) noexcept {
+   position_ = std::min(position, size_);
+}
+
+std::size_t blob_stream::read(void *data, std::size_t size) {
+   std::error_code ec;
+   auto result = read(data, size, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+   return result;
+}
+
+std::size_t blob_stream::read(void *data, std::size_t size, std::error_code &ec) noexcept {
+   if (!blob_) {
+      ec = std::make_error_code(std::errc::bad_file_descriptor);
+      return 0;
+   }
+
+   // Blob sizes are limited to int by SQLite, so are the chunks
+   const auto max_chunk = static_cast<std::size_t>(std::numeric_limits<int>::max());
+   const auto to_read = std::min({size, size_ - position_, max_chunk});
+   if (to_read == 0) {
+      return 0;
+   }
+
+   ec = errors::make_error_code(
+       ::sqlite3_blob_read(blob_, data, static_cast<int>(to_read), static_cast<int>(position_)));
+   if (ec) {
+      return 0;
+   }
+
+   position_ += to_read;
+   return to_read;
+}
+
+void blob_stream::write(const void *data, std::size_t size) {
+   std::error_code ec;
+   write(data, size, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void blob_stream::write(const void *data, std::size_t size, std::error_code &ec) noexcept {
+   if (!blob_) {
+      ec = std::make_error_code(std::errc::bad_file_descriptor);
+      return;
+   }
+
+   if (size > size_ - position_) {
+      // Blobs cannot grow
+      ec = std::make_error_code(std::errc::no_buffer_space);
+      return;
+   }
+
+   ec = errors::make_error_code(
+       ::sqlite3_blob_write(blob_, data, static_cast<int>(size), static_cast<int>(position_)));
+   if (ec) {
+      return;
+   }
+
+   position_ += size;
+}
+
+void blob_stream::read_into(std::ostream &output, std::size_t chunk_size) {
+   std::error_code ec;
+   read_into(output, chunk_size, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void blob_stream::read_into(std::ostream &output, std::size_t chunk_size, std::error_code &ec) {
+   if (chunk_size == 0) {
+      ec = std::make_error_code(std::errc::invalid_argument);
+      return;
+   }
+
+   std::vector<char> buffer(std::min(chunk_size, size_ - position_));
+   while (position_ < size_) {
+      const auto num_read = read(buffer.data(), buffer.size(), ec);
+      if (ec) {
+         return;
+      }
+
+      if (!output.write(buffer.data(), static_cast<std::streamsize>(num_read))) {
+         ec = std::make_error_code(std::errc::io_error);
+         return;
+      }
+   }
+}
+
+void blob_stream::write_from(std::istream &input, std::size_t chunk_size) {
+   std::error_code ec;
+   write_from(input, chunk_size, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void blob_stream::write_from(std::istream &input, std::size_t chunk_size, std::error_code &ec) {
+   if (chunk_size == 0) {
+      ec = std::make_error_code(std::errc::invalid_argument);
+      return;
+   }
+
+   std::vector<char> buffer(std::min(chunk_size, size_ - position_));
+   while (position_ < size_) {
+      const auto to_read = std::min(buffer.size(), size_ - position_);
+      if (!input.read(buffer.data(), static_cast<std::streamsize>(to_read))) {
+         ec = std::make_error_code(std::errc::io_error);
+         return;
+      }
+
+      write(buffer.data(), to_read, ec);
+      if (ec) {
+         return;
+      }
+   }
+}
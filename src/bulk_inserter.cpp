@@ -0,0 +1,154 @@
+/**
+ * @file   bulk_inserter.cpp
+ */
+
+#include <sqlite-burrito/bulk_inserter.h>
+
+#include <algorithm>
+
+using namespace sqlite_burrito;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Statistics
+////////////////////////////////////////////////////////////////////////////////
+double bulk_inserter::statistics::rows_per_second() const noexcept {
+   using seconds_t = std::chrono::duration<double>;
+
+   const auto seconds = std::chrono::duration_cast<seconds_t>(elapsed).count();
+   if (seconds <= 0.0) {
+      return 0.0;
+   }
+
+   return static_cast<double>(rows) / seconds;
+}
+
+bulk_inserter::clock_t::duration bulk_inserter::statistics::average_commit_time() const noexcept {
+   if (!commits) {
+      return clock_t::duration{0};
+   }
+
+   return total_commit_time / static_cast<clock_t::duration::rep>(commits);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Inserter
+////////////////////////////////////////////////////////////////////////////////
+bulk_inserter::bulk_inserter(connection &con, statement &insert)
+   : bulk_inserter(con, insert, options{}) {
+   // Nothing to do here
+}
+
+bulk_inserter::bulk_inserter(connection &con, statement &insert, options opts)
+   : con_{&con}
+   , insert_{&insert}
+   , options_{opts} {
+   // Nothing to do here
+}
+
+bulk_inserter::~bulk_inserter() {
+   // Errors cannot be reported from the destructor, use `flush` to observe them
+   std::error_code ec;
+   flush(ec);
+   if (ec) {
+      discard();
+   }
+}
+
+void bulk_inserter::flush() {
+   std::error_code ec;
+   flush(ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void bulk_inserter::flush(std::error_code &ec) noexcept {
+   if (!batch_) {
+      return;
+   }
+
+   const auto start = clock_t::now();
+   batch_->commit(ec);
+   const auto end = clock_t::now();
+
+   if (ec) {
+      // A failed commit leaves the transaction open, the batch can be flushed again (or discarded)
+      return;
+   }
+
+   batch_.reset();
+
+   const auto commit_time = end - start;
+   stats_.rows += pending_;
+   stats_.commits += 1;
+   stats_.total_commit_time += commit_time;
+   stats_.max_commit_time = std::max(stats_.max_commit_time, commit_time);
+   stats_.elapsed = end - first_start_;
+
+   pending_ = 0;
+}
+
+void bulk_inserter::flush_if_due() {
+   std::error_code ec;
+   flush_if_due(ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void bulk_inserter::flush_if_due(std::error_code &ec) noexcept {
+   if (batch_ && options_.batch_time.count() && (clock_t::now() - batch_start_) >= options_.batch_time) {
+      flush(ec);
+   }
+}
+
+void bulk_inserter::discard() noexcept {
+   if (batch_) {
+      std::error_code ec;
+      batch_->rollback(ec);
+      batch_.reset();
+   }
+
+   pending_ = 0;
+}
+
+void bulk_inserter::begin_row(std::error_code &ec) noexcept {
+   if (batch_) {
+      return;
+   }
+
+   try {
+      batch_.emplace(*con_, transaction::behavior::immediate);
+   } catch (const std::system_error &e) {
+      ec = e.code();
+      return;
+   } catch (const std::bad_alloc &) {
+      ec = std::make_error_code(std::errc::not_enough_memory);
+      return;
+   }
+
+   batch_start_ = clock_t::now();
+   if (stats_.commits == 0) {
+      first_start_ = batch_start_;
+   }
+}
+
+void bulk_inserter::end_row(std::error_code &ec) noexcept {
+   insert_->execute(ec);
+
+   // Make the statement ready for the next row, a failed step is already reported via `ec`
+   std::error_code reset_ec;
+   insert_->reset(reset_ec);
+
+   if (ec) {
+      return;
+   }
+
+   ++pending_;
+
+   const bool rows_reached = options_.batch_rows && pending_ >= options_.batch_rows;
+   const bool time_reached = options_.batch_time.count() && (clock_t::now() - batch_start_) >= options_.batch_time;
+   if (rows_reached || time_reached) {
+      flush(ec);
+   }
+}
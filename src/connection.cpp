@@ -6,40 +6,254 @@
 
 #include <sqlite-burrito/connection.h>
 #include <sqlite-burrito/errors/sqlite.h>
+#include <sqlite-burrito/statement_cache.h>
 
 #include <sqlite3.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <random>
+#include <string>
 #include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 using namespace sqlite_burrito;
 
-connection::connection(open_flags flags)
-   : flags_{flags}
-   , connection_{nullptr} {
-   // Nothing to do here
+struct connection::savepoint_statements {
+   using statements_t = std::array<::sqlite3_stmt *, static_cast<int>(savepoint_control::count)>;
+
+   //! Statements for each nesting depth, starting from 1
+   std::vector<statements_t> by_depth{};
+};
+
+struct connection::busy_state {
+   using clock_t = std::chrono::steady_clock;
+
+   busy_policy policy{};
+
+   //! Whether the handler is installed (the counters are kept after clearing the policy)
+   bool active{false};
+
+   //! Start of the current busy event
+   clock_t::time_point event_start{};
+
+   std::minstd_rand random{static_cast<std::minstd_rand::result_type>(clock_t::now().time_since_epoch().count())};
+
+   //! Counters are read from the metrics threads
+   std::atomic<std::uint64_t> events{0};
+   std::atomic<std::uint64_t> retries{0};
+   std::atomic<std::uint64_t> failures{0};
+   std::atomic<std::int64_t> wait_ns{0};
+};
+
+namespace {
+
+const char *to_string(connection_options::journal_mode mode) {
+   using mode_t = connection_options::journal_mode;
+   switch (mode) {
+      case mode_t::delete_journal:
+         return "DELETE";
+      case mode_t::truncate:
+         return "TRUNCATE";
+      case mode_t::persist:
+         return "PERSIST";
+      case mode_t::memory:
+         return "MEMORY";
+      case mode_t::wal:
+         return "WAL";
+      case mode_t::off:
+         return "OFF";
+   }
+   return nullptr;
 }
 
-connection::~connection() {
-   using namespace std::chrono_literals;
-   using namespace std::chrono;
+const char *to_string(connection_options::synchronous_mode mode) {
+   using mode_t = connection_options::synchronous_mode;
+   switch (mode) {
+      case mode_t::off:
+         return "OFF";
+      case mode_t::normal:
+         return "NORMAL";
+      case mode_t::full:
+         return "FULL";
+      case mode_t::extra:
+         return "EXTRA";
+   }
+   return nullptr;
+}
+
+const char *to_string(connection_options::temp_store_mode mode) {
+   using mode_t = connection_options::temp_store_mode;
+   switch (mode) {
+      case mode_t::default_store:
+         return "DEFAULT";
+      case mode_t::file:
+         return "FILE";
+      case mode_t::memory:
+         return "MEMORY";
+   }
+   return nullptr;
+}
+
+const char *to_string(connection_options::locking_mode_t mode) {
+   using mode_t = connection_options::locking_mode_t;
+   switch (mode) {
+      case mode_t::normal:
+         return "NORMAL";
+      case mode_t::exclusive:
+         return "EXCLUSIVE";
+   }
+   return nullptr;
+}
+
+template <typename T>
+void append_pragma(std::string &sql, const char *name, const std::optional<T> &value, std::error_code &ec) {
+   if (!value || ec) {
+      return;
+   }
+
+   sql += "PRAGMA ";
+   sql += name;
+   sql += " = ";
+
+   if constexpr (std::is_same_v<T, bool>) {
+      sql += *value ? "ON" : "OFF";
+   } else if constexpr (std::is_enum_v<T>) {
+      auto str = to_string(*value);
+      if (!str) {
+         ec = std::make_error_code(std::errc::invalid_argument);
+         return;
+      }
+      sql += str;
+   } else {
+      sql += std::to_string(*value);
+   }
+
+   sql += ";";
+}
 
-   const auto close_timeout = 5s;
-   const auto sleep_duration = 50ms;
+//! Switch the journal mode. SQLite reports the resulting mode, and silently keeps the current one if it can't be
+//! changed (e.g. in-memory databases only support the MEMORY and OFF modes).
+void apply_journal_mode(::sqlite3 *con, const std::string &sql, const char *mode, std::error_code &ec) {
+   ::sqlite3_stmt *stmt{nullptr};
+   ec = errors::make_error_code(::sqlite3_prepare_v2(con, sql.c_str(), -1, &stmt, nullptr));
+   if (ec) {
+      return;
+   }
+
+   auto rc = ::sqlite3_step(stmt);
+   if (rc == SQLITE_ROW) {
+      auto current = reinterpret_cast<const char *>(::sqlite3_column_text(stmt, 0));
+      if (!current || ::sqlite3_stricmp(current, mode) != 0) {
+         ec = std::make_error_code(std::errc::not_supported);
+      }
+   } else {
+      ec = errors::make_error_code(rc == SQLITE_DONE ? SQLITE_ERROR : rc);
+   }
+
+   ::sqlite3_finalize(stmt);
+}
+
+//! Apply the options to a freshly opened connection
+void apply_options(::sqlite3 *con, const connection_options &options, std::error_code &ec) {
+   // The order matters: the page size can't be changed once in the WAL mode, and the exclusive locking mode avoids
+   // creating the WAL shared memory file, only if it's set before switching to the WAL mode.
+   std::string before_journal;
+   append_pragma(before_journal, "page_size", options.page_size, ec);
+   append_pragma(before_journal, "locking_mode", options.locking_mode, ec);
 
-   auto start = steady_clock::now();
+   std::string journal;
+   append_pragma(journal, "journal_mode", options.journal, ec);
 
-   auto rc = ::sqlite3_close(connection_);
-   while (rc != SQLITE_OK) {
-      if ((steady_clock::now() - start) > close_timeout) {
-         break;
+   std::string after_journal;
+   append_pragma(after_journal, "synchronous", options.synchronous, ec);
+   append_pragma(after_journal, "cache_size", options.cache_size, ec);
+   append_pragma(after_journal, "mmap_size", options.mmap_size, ec);
+   append_pragma(after_journal, "temp_store", options.temp_store, ec);
+   append_pragma(after_journal, "wal_autocheckpoint", options.wal_autocheckpoint, ec);
+   append_pragma(after_journal, "foreign_keys", options.foreign_keys, ec);
+
+   if (ec) {
+      return;
+   }
+
+   if (!before_journal.empty()) {
+      ec = errors::make_error_code(::sqlite3_exec(con, before_journal.c_str(), nullptr, nullptr, nullptr));
+      if (ec) {
+         return;
       }
+   }
+
+   if (!journal.empty()) {
+      apply_journal_mode(con, journal, to_string(*options.journal), ec);
+      if (ec) {
+         return;
+      }
+   }
 
-      std::this_thread::sleep_for(sleep_duration);
-      rc = ::sqlite3_close(connection_);
+   if (!after_journal.empty()) {
+      ec = errors::make_error_code(::sqlite3_exec(con, after_journal.c_str(), nullptr, nullptr, nullptr));
    }
 }
 
+//! Execute a PRAGMA statement, returning a single integer value
+std::int64_t query_int64_pragma(::sqlite3 *con, const char *sql, std::error_code &ec) {
+   if (!con) {
+      ec = errors::make_error_code(SQLITE_MISUSE);
+      return 0;
+   }
+
+   ::sqlite3_stmt *stmt{nullptr};
+   ec = errors::make_error_code(::sqlite3_prepare_v2(con, sql, -1, &stmt, nullptr));
+   if (ec) {
+      return 0;
+   }
+
+   std::int64_t result{0};
+   auto rc = ::sqlite3_step(stmt);
+   if (rc == SQLITE_ROW) {
+      result = ::sqlite3_column_int64(stmt, 0);
+   } else if (rc != SQLITE_DONE) {
+      ec = errors::make_error_code(rc);
+   }
+
+   ::sqlite3_finalize(stmt);
+   return result;
+}
+
+//! Close a handle, which might be kept alive as a zombie by the outstanding statements
+int close_handle(::sqlite3 *handle) noexcept {
+   if (!handle) {
+      return SQLITE_OK;
+   }
+
+   // Zombies might outlive the busy state, referenced by the handler
+   ::sqlite3_busy_handler(handle, nullptr, nullptr);
+   return ::sqlite3_close_v2(handle);
+}
+
+} // namespace
+
+connection::connection(open_flags flags)
+   : flags_{flags}
+   , connection_{nullptr} {
+   // Nothing to do here
+}
+
+connection::~connection() {
+   // Outstanding statements are not reported here: they are still valid, and will release the connection once they
+   // are destroyed themselves.
+   delete cache_;
+   finalize_control();
+
+   close_handle(connection_);
+   delete busy_;
+}
+
 void connection::open(std::string_view filename) {
    std::error_code ec;
    open(filename, ec);
@@ -49,17 +263,332 @@ void connection::open(std::string_view filename) {
 }
 
 void connection::open(std::string_view filename, std::error_code &ec) noexcept {
+   open(filename, connection_options{}, ec);
+}
+
+void connection::open(std::string_view filename, const connection_options &options) {
+   std::error_code ec;
+   open(filename, options, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void connection::open(std::string_view filename, const connection_options &options, std::error_code &ec) noexcept {
    native_handle_t new_connection{nullptr};
    int result = ::sqlite3_open_v2(filename.data(), &new_connection, static_cast<int>(flags_), nullptr);
 
    ec = errors::make_error_code(result);
-
    if (!ec && new_connection) {
-      ::sqlite3_close(connection_);
-      connection_ = new_connection;
+      if (busy_ && busy_->active) {
+         // Applying the options might already require some locks
+         ::sqlite3_busy_handler(new_connection, &connection::on_busy, busy_);
+      }
+
+      apply_options(new_connection, options, ec);
+   }
+
+   if (ec) {
+      // The old connection is kept intact
+      close_handle(new_connection);
+      return;
+   }
+
+   if (cache_) {
+      // Cached statements belong to the old connection
+      cache_->clear();
+   }
+   finalize_control();
+
+   close_handle(connection_);
+   connection_ = new_connection;
+}
+
+std::vector<std::string> connection::close() {
+   std::error_code ec;
+   auto result = close(ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+   return result;
+}
+
+std::vector<std::string> connection::close(std::error_code &ec) {
+   if (!connection_) {
+      return {};
+   }
+
+   if (cache_) {
+      cache_->clear();
+   }
+   finalize_control();
+
+   // Has to be collected before closing, the connection handle is not usable afterwards
+   auto result = outstanding_statements();
+
+   ec = errors::make_error_code(close_handle(connection_));
+   if (!ec) {
+      connection_ = nullptr;
+   } else if (busy_ && busy_->active) {
+      // The connection is still usable
+      ::sqlite3_busy_handler(connection_, &connection::on_busy, busy_);
+   }
+
+   return result;
+}
+
+std::vector<std::string> connection::outstanding_statements() const {
+   std::vector<std::string> result;
+   if (!connection_) {
+      return result;
+   }
+
+   for (auto stmt = ::sqlite3_next_stmt(connection_, nullptr); stmt; stmt = ::sqlite3_next_stmt(connection_, stmt)) {
+      auto sql = ::sqlite3_sql(stmt);
+      result.emplace_back(sql ? sql : "");
+   }
+
+   return result;
+}
+
+void connection::set_busy_policy(const busy_policy &policy) {
+   std::error_code ec;
+   set_busy_policy(policy, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void connection::set_busy_policy(const busy_policy &policy, std::error_code &ec) noexcept {
+   if (policy.jitter < 0.0 || policy.jitter > 1.0 || policy.max_retries < 0 ||
+       policy.initial_delay.count() <= 0 || policy.max_delay < policy.initial_delay) {
+      ec = std::make_error_code(std::errc::invalid_argument);
+      return;
+   }
+
+   if (!busy_) {
+      busy_ = new busy_state();
+   }
+   busy_->policy = policy;
+   busy_->active = true;
+
+   if (connection_) {
+      ec = errors::make_error_code(::sqlite3_busy_handler(connection_, &connection::on_busy, busy_));
+   }
+}
+
+void connection::clear_busy_policy() noexcept {
+   if (connection_) {
+      ::sqlite3_busy_handler(connection_, nullptr, nullptr);
+   }
+
+   if (busy_) {
+      busy_->active = false;
    }
 }
 
+connection::busy_statistics connection::busy_stats() const noexcept {
+   busy_statistics result;
+   if (busy_) {
+      result.events = busy_->events;
+      result.retries = busy_->retries;
+      result.failures = busy_->failures;
+      result.wait_time = std::chrono::nanoseconds{busy_->wait_ns};
+   }
+   return result;
+}
+
+int connection::on_busy(void *ptr, int count) noexcept {
+   using namespace std::chrono;
+
+   auto &state = *static_cast<busy_state *>(ptr);
+   const auto &policy = state.policy;
+
+   const auto now = busy_state::clock_t::now();
+   if (count == 0) {
+      state.event_start = now;
+      ++state.events;
+   }
+
+   const auto remaining = policy.timeout - (now - state.event_start);
+   if (remaining <= nanoseconds::zero() || (policy.max_retries > 0 && count >= policy.max_retries)) {
+      ++state.failures;
+      return 0;
+   }
+
+   // Exponential backoff, capped both by the maximal delay and the remaining time
+   auto delay = duration<double, std::micro>{policy.max_delay};
+   if (count < 32) {
+      delay = std::min(delay, duration<double, std::micro>{policy.initial_delay} * static_cast<double>(1ULL << count));
+   }
+
+   std::uniform_real_distribution<double> distribution{1.0 - policy.jitter, 1.0};
+   delay *= distribution(state.random);
+
+   const auto sleep_for = std::min<nanoseconds>(duration_cast<nanoseconds>(delay), remaining);
+   std::this_thread::sleep_for(sleep_for);
+
+   ++state.retries;
+   state.wait_ns += duration_cast<nanoseconds>(busy_state::clock_t::now() - now).count();
+
+   return 1;
+}
+
+std::int64_t connection::set_mmap_size(std::int64_t bytes) {
+   std::error_code ec;
+   auto result = set_mmap_size(bytes, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+   return result;
+}
+
+std::int64_t connection::set_mmap_size(std::int64_t bytes, std::error_code &ec) noexcept {
+   if (bytes < 0) {
+      ec = std::make_error_code(std::errc::invalid_argument);
+      return 0;
+   }
+
+   const auto sql = "PRAGMA mmap_size = " + std::to_string(bytes) + ";";
+   return query_int64_pragma(connection_, sql.c_str(), ec);
+}
+
+std::int64_t connection::mmap_size() {
+   std::error_code ec;
+   auto result = mmap_size(ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+   return result;
+}
+
+std::int64_t connection::mmap_size(std::error_code &ec) noexcept {
+   return query_int64_pragma(connection_, "PRAGMA mmap_size;", ec);
+}
+
+database_image connection::serialize() {
+   std::error_code ec;
+   auto result = serialize(ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+   return result;
+}
+
+database_image connection::serialize(std::error_code &ec) noexcept {
+   if (!connection_) {
+      ec = errors::make_error_code(SQLITE_MISUSE);
+      return database_image{};
+   }
+
+   sqlite3_int64 size = 0;
+   auto data = ::sqlite3_serialize(connection_, "main", &size, 0);
+   if (!data) {
+      // An empty in-memory database has no pages to serialize, failures are reported with a negative size
+      if (size > 0) {
+         ec = errors::make_error_code(SQLITE_NOMEM);
+      } else if (size < 0) {
+         ec = errors::make_error_code(SQLITE_ERROR);
+      }
+      return database_image{};
+   }
+
+   return database_image::adopt(data, static_cast<std::size_t>(size));
+}
+
+void connection::deserialize(database_image &&image, deserialize_flags flags) {
+   std::error_code ec;
+   deserialize(std::move(image), flags, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void connection::deserialize(database_image &&image, deserialize_flags flags, std::error_code &ec) noexcept {
+   if (!connection_) {
+      // The ownership is taken regardless
+      ::sqlite3_free(image.release());
+      ec = errors::make_error_code(SQLITE_MISUSE);
+      return;
+   }
+
+   const auto size = static_cast<sqlite3_int64>(image.size());
+   const auto native_flags = static_cast<unsigned>(flags) | SQLITE_DESERIALIZE_FREEONCLOSE;
+
+   // SQLite takes care of the buffer from here on, even on failures
+   ec = errors::make_error_code(::sqlite3_deserialize(connection_, "main", image.release(), size, size, native_flags));
+}
+
+connection::io_statistics connection::io_stats(bool reset) {
+   std::error_code ec;
+   auto result = io_stats(reset, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+   return result;
+}
+
+connection::io_statistics connection::io_stats(bool reset, std::error_code &ec) noexcept {
+   if (!connection_) {
+      ec = errors::make_error_code(SQLITE_MISUSE);
+      return {};
+   }
+
+   const auto counter = [this, reset](int op) -> std::uint64_t {
+      int current = 0;
+      int highwater = 0;
+      ::sqlite3_db_status(connection_, op, &current, &highwater, reset ? 1 : 0);
+      return static_cast<std::uint64_t>(current);
+   };
+
+   io_statistics result;
+   result.cache_hits = counter(SQLITE_DBSTATUS_CACHE_HIT);
+   result.cache_misses = counter(SQLITE_DBSTATUS_CACHE_MISS);
+   result.cache_writes = counter(SQLITE_DBSTATUS_CACHE_WRITE);
+   result.cache_spills = counter(SQLITE_DBSTATUS_CACHE_SPILL);
+   result.mmap_size = mmap_size(ec);
+
+   return result;
+}
+
+connection::statistics connection::stats(bool reset_highwater) {
+   std::error_code ec;
+   auto result = stats(reset_highwater, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+   return result;
+}
+
+connection::statistics connection::stats(bool reset_highwater, std::error_code &ec) noexcept {
+   if (!connection_) {
+      ec = errors::make_error_code(SQLITE_MISUSE);
+      return {};
+   }
+
+   const auto read_status = [this](int op, bool reset) {
+      int current = 0;
+      int highwater = 0;
+      ::sqlite3_db_status(connection_, op, &current, &highwater, reset ? 1 : 0);
+      return status_counter{current, highwater};
+   };
+
+   statistics result;
+   result.lookaside_used = read_status(SQLITE_DBSTATUS_LOOKASIDE_USED, reset_highwater);
+   result.lookaside_hits = read_status(SQLITE_DBSTATUS_LOOKASIDE_HIT, reset_highwater);
+   result.lookaside_misses_size = read_status(SQLITE_DBSTATUS_LOOKASIDE_MISS_SIZE, reset_highwater);
+   result.lookaside_misses_full = read_status(SQLITE_DBSTATUS_LOOKASIDE_MISS_FULL, reset_highwater);
+
+   result.cache_used = read_status(SQLITE_DBSTATUS_CACHE_USED, false).current;
+   result.cache_used_shared = read_status(SQLITE_DBSTATUS_CACHE_USED_SHARED, false).current;
+   result.schema_used = read_status(SQLITE_DBSTATUS_SCHEMA_USED, false).current;
+   result.statement_used = read_status(SQLITE_DBSTATUS_STMT_USED, false).current;
+
+   result.io = io_stats(false, ec);
+
+   return result;
+}
+
 std::int64_t connection::last_insert_rowid() {
    return ::sqlite3_last_insert_rowid(connection_);
 }
@@ -71,3 +600,128 @@ std::error_code connection::last_error() const noexcept {
 transaction connection::begin_transaction(transaction::behavior behavior) {
    return transaction{*this, behavior};
 }
+
+statement_cache &connection::cache() {
+   if (!cache_) {
+      cache_ = new statement_cache(*this);
+   }
+   return *cache_;
+}
+
+void connection::execute_control(control kind, std::error_code &ec) noexcept {
+   auto &stmt = control_[static_cast<int>(kind)];
+   if (!stmt) {
+      const char *sql;
+      switch (kind) {
+         case control::begin_deferred:
+            sql = "BEGIN DEFERRED";
+            break;
+
+         case control::begin_immediate:
+            sql = "BEGIN IMMEDIATE";
+            break;
+
+         case control::begin_exclusive:
+            sql = "BEGIN EXCLUSIVE";
+            break;
+
+         case control::commit:
+            sql = "COMMIT TRANSACTION";
+            break;
+
+         case control::rollback:
+            sql = "ROLLBACK TRANSACTION";
+            break;
+
+         default:
+            ec = std::make_error_code(std::errc::invalid_argument);
+            return;
+      }
+
+      ec = errors::make_error_code(::sqlite3_prepare_v3(connection_, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr));
+      if (ec) {
+         return;
+      }
+   }
+
+   ec = errors::make_error_code(::sqlite3_step(stmt));
+   if (ec == errors::condition::done) {
+      ec = errors::code::ok;
+   }
+
+   // Don't keep the statement active between the calls
+   ::sqlite3_reset(stmt);
+}
+
+void connection::execute_savepoint_control(savepoint_control kind, int depth, std::error_code &ec) noexcept {
+   if (depth < 1) {
+      ec = std::make_error_code(std::errc::invalid_argument);
+      return;
+   }
+
+   if (!savepoints_) {
+      savepoints_ = new savepoint_statements();
+   }
+
+   auto &by_depth = savepoints_->by_depth;
+   const auto depth_idx = static_cast<std::size_t>(depth - 1);
+   if (by_depth.size() <= depth_idx) {
+      by_depth.resize(depth_idx + 1, savepoint_statements::statements_t{});
+   }
+
+   auto &stmt = by_depth[depth_idx][static_cast<int>(kind)];
+   if (!stmt) {
+      std::string sql;
+      switch (kind) {
+         case savepoint_control::begin:
+            sql = "SAVEPOINT ";
+            break;
+
+         case savepoint_control::release:
+            sql = "RELEASE SAVEPOINT ";
+            break;
+
+         case savepoint_control::rollback:
+            sql = "ROLLBACK TO SAVEPOINT ";
+            break;
+
+         default:
+            ec = std::make_error_code(std::errc::invalid_argument);
+            return;
+      }
+      sql += "sqlite_burrito_sp_" + std::to_string(depth);
+
+      ec = errors::make_error_code(
+          ::sqlite3_prepare_v3(connection_, sql.c_str(), -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr));
+      if (ec) {
+         return;
+      }
+   }
+
+   ec = errors::make_error_code(::sqlite3_step(stmt));
+   if (ec == errors::condition::done) {
+      ec = errors::code::ok;
+   }
+
+   ::sqlite3_reset(stmt);
+}
+
+void connection::finalize_control() noexcept {
+   for (auto &stmt : control_) {
+      ::sqlite3_finalize(stmt);
+      stmt = nullptr;
+   }
+
+   if (savepoints_) {
+      for (auto &statements : savepoints_->by_depth) {
+         for (auto stmt : statements) {
+            ::sqlite3_finalize(stmt);
+         }
+      }
+
+      delete savepoints_;
+      savepoints_ = nullptr;
+   }
+
+   savepoint_depth_ = 0;
+}
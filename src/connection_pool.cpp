@@ -0,0 +1,345 @@
+/**
+ * @file   connection_pool.cpp
+ */
+
+#include <sqlite-burrito/connection_pool.h>
+#include <sqlite-burrito/statement.h>
+#include <sqlite-burrito/transaction.h>
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+
+using namespace sqlite_burrito;
+
+struct connection_pool::impl {
+   using clock_t = std::chrono::steady_clock;
+
+   std::unique_ptr<connection> writer{};
+   std::vector<std::unique_ptr<connection>> readers{};
+
+   //! Readers, which are not leased out at the moment
+   std::vector<connection *> idle_readers{};
+   bool writer_idle{false};
+
+   mutable std::mutex mutex{};
+   std::condition_variable reader_available{};
+   std::condition_variable writer_available{};
+
+   statistics stats{};
+   clock_t::time_point opened_at{clock_t::now()};
+
+   void open_connection(connection &con, std::string_view path, const options &opts, bool writer, std::error_code &ec) {
+      auto settings = opts.settings;
+      if (!writer) {
+         // Read-only connections can't switch the journal mode
+         settings.journal.reset();
+      }
+
+      con.open(path, settings, ec);
+      if (ec) {
+         return;
+      }
+
+      connection::busy_policy policy;
+      policy.timeout = opts.busy_timeout;
+      con.set_busy_policy(policy, ec);
+      if (ec) {
+         return;
+      }
+
+      for (const auto &pragma : opts.pragmas) {
+         statement::execute(con, pragma, ec);
+         if (ec) {
+            return;
+         }
+      }
+   }
+
+   void record_wait(bool writer, clock_t::duration waited) {
+      auto &total = writer ? stats.writer_wait_time : stats.reader_wait_time;
+      auto &max = writer ? stats.max_writer_wait_time : stats.max_reader_wait_time;
+
+      total += waited;
+      max = std::max<std::chrono::nanoseconds>(max, waited);
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Statistics
+////////////////////////////////////////////////////////////////////////////////
+double connection_pool::statistics::reader_utilization() const noexcept {
+   if (readers == 0 || elapsed.count() == 0) {
+      return 0.0;
+   }
+   return static_cast<double>(reader_busy_time.count()) / (static_cast<double>(elapsed.count()) * readers);
+}
+
+double connection_pool::statistics::writer_utilization() const noexcept {
+   if (elapsed.count() == 0) {
+      return 0.0;
+   }
+   return static_cast<double>(writer_busy_time.count()) / static_cast<double>(elapsed.count());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Lease
+////////////////////////////////////////////////////////////////////////////////
+connection_pool::lease::lease(connection_pool *pool, connection *con, bool writer) noexcept
+   : pool_{pool}
+   , con_{con}
+   , writer_{writer}
+   , since_{std::chrono::steady_clock::now()} {
+   // Nothing to do here
+}
+
+connection_pool::lease::lease(lease &&other) noexcept
+   : pool_{other.pool_}
+   , con_{other.con_}
+   , writer_{other.writer_}
+   , since_{other.since_} {
+   other.pool_ = nullptr;
+   other.con_ = nullptr;
+}
+
+connection_pool::lease::~lease() {
+   release();
+}
+
+connection_pool::lease &connection_pool::lease::operator=(lease &&other) noexcept {
+   if (this != &other) {
+      release();
+
+      pool_ = other.pool_;
+      con_ = other.con_;
+      writer_ = other.writer_;
+      since_ = other.since_;
+
+      other.pool_ = nullptr;
+      other.con_ = nullptr;
+   }
+   return *this;
+}
+
+void connection_pool::lease::release() noexcept {
+   if (pool_ && con_) {
+      pool_->give_back(*this);
+   }
+
+   pool_ = nullptr;
+   con_ = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Pool
+////////////////////////////////////////////////////////////////////////////////
+connection_pool::connection_pool()
+   : connection_pool(options{}) {
+   // Nothing to do here
+}
+
+connection_pool::connection_pool(options opts)
+   : options_{std::move(opts)}
+   , impl_{new impl()} {
+   // Nothing to do here
+}
+
+connection_pool::~connection_pool() {
+   delete impl_;
+}
+
+void connection_pool::open(std::string_view path) {
+   std::error_code ec;
+   open(path, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void connection_pool::open(std::string_view path, std::error_code &ec) noexcept {
+   using open_flags = connection::open_flags;
+
+   try {
+      // Each connection is only used by a single thread at a time, so there is no need for the per-connection mutex
+      const auto extra_flags = open_flags::uri | open_flags::no_mutex;
+
+      auto writer = std::make_unique<connection>(open_flags::default_mode | extra_flags);
+      impl_->open_connection(*writer, path, options_, true, ec);
+      if (ec) {
+         return;
+      }
+
+      std::vector<std::unique_ptr<connection>> readers;
+      for (std::size_t i = 0; i < options_.readers; ++i) {
+         auto reader = std::make_unique<connection>(open_flags::readonly | extra_flags);
+         impl_->open_connection(*reader, path, options_, false, ec);
+         if (ec) {
+            return;
+         }
+         readers.push_back(std::move(reader));
+      }
+
+      std::lock_guard lock{impl_->mutex};
+
+      impl_->writer = std::move(writer);
+      impl_->writer_idle = true;
+
+      impl_->readers = std::move(readers);
+      impl_->idle_readers.clear();
+      for (auto &reader : impl_->readers) {
+         impl_->idle_readers.push_back(reader.get());
+      }
+
+      impl_->stats = statistics{};
+      impl_->stats.readers = impl_->readers.size();
+      impl_->opened_at = impl::clock_t::now();
+   } catch (const std::bad_alloc &) {
+      ec = std::make_error_code(std::errc::not_enough_memory);
+   }
+}
+
+connection_pool::lease connection_pool::reader() {
+   std::error_code ec;
+   auto result = reader(std::chrono::milliseconds::max(), ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+   return result;
+}
+
+connection_pool::lease connection_pool::reader(std::chrono::milliseconds timeout, std::error_code &ec) {
+   if (options_.readers == 0) {
+      return writer(timeout, ec);
+   }
+
+   const auto start = impl::clock_t::now();
+
+   std::unique_lock lock{impl_->mutex};
+   if (impl_->readers.empty()) {
+      // Not opened yet
+      ec = std::make_error_code(std::errc::not_connected);
+      return {};
+   }
+
+   const auto available = [this] { return !impl_->idle_readers.empty(); };
+   if (timeout == std::chrono::milliseconds::max()) {
+      impl_->reader_available.wait(lock, available);
+   } else if (!impl_->reader_available.wait_for(lock, timeout, available)) {
+      impl_->stats.timeouts += 1;
+      ec = std::make_error_code(std::errc::timed_out);
+      return {};
+   }
+
+   auto con = impl_->idle_readers.back();
+   impl_->idle_readers.pop_back();
+
+   impl_->stats.reader_acquisitions += 1;
+   impl_->stats.readers_in_use += 1;
+   impl_->record_wait(false, impl::clock_t::now() - start);
+
+   return lease{this, con, false};
+}
+
+connection_pool::lease connection_pool::writer() {
+   std::error_code ec;
+   auto result = writer(std::chrono::milliseconds::max(), ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+   return result;
+}
+
+connection_pool::lease connection_pool::writer(std::chrono::milliseconds timeout, std::error_code &ec) {
+   const auto start = impl::clock_t::now();
+
+   std::unique_lock lock{impl_->mutex};
+   if (!impl_->writer) {
+      // Not opened yet
+      ec = std::make_error_code(std::errc::not_connected);
+      return {};
+   }
+
+   const auto available = [this] { return impl_->writer_idle; };
+   if (timeout == std::chrono::milliseconds::max()) {
+      impl_->writer_available.wait(lock, available);
+   } else if (!impl_->writer_available.wait_for(lock, timeout, available)) {
+      impl_->stats.timeouts += 1;
+      ec = std::make_error_code(std::errc::timed_out);
+      return {};
+   }
+
+   impl_->writer_idle = false;
+
+   impl_->stats.writer_acquisitions += 1;
+   impl_->stats.writers_in_use += 1;
+   impl_->record_wait(true, impl::clock_t::now() - start);
+
+   return lease{this, impl_->writer.get(), true};
+}
+
+void connection_pool::write(const write_funct_t &func) {
+   std::error_code ec;
+   write(func, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void connection_pool::write(const write_funct_t &func, std::error_code &ec) {
+   auto con = writer(std::chrono::milliseconds::max(), ec);
+   if (ec) {
+      return;
+   }
+
+   try {
+      transaction trans{*con, transaction::behavior::immediate};
+
+      func(*con, ec);
+      if (ec) {
+         // Keep the original error
+         std::error_code rollback_ec;
+         trans.rollback(rollback_ec);
+         return;
+      }
+
+      trans.commit(ec);
+   } catch (const std::system_error &e) {
+      ec = e.code();
+   }
+}
+
+connection_pool::statistics connection_pool::stats() const noexcept {
+   std::lock_guard lock{impl_->mutex};
+
+   auto result = impl_->stats;
+   result.elapsed = impl::clock_t::now() - impl_->opened_at;
+
+   return result;
+}
+
+void connection_pool::give_back(lease &lease) noexcept {
+   const auto busy = impl::clock_t::now() - lease.since_;
+
+   {
+      std::lock_guard lock{impl_->mutex};
+      if (lease.writer_) {
+         impl_->writer_idle = true;
+         impl_->stats.writers_in_use -= 1;
+         impl_->stats.writer_busy_time += busy;
+      } else {
+         impl_->idle_readers.push_back(lease.con_);
+         impl_->stats.readers_in_use -= 1;
+         impl_->stats.reader_busy_time += busy;
+      }
+   }
+
+   if (lease.writer_) {
+      impl_->writer_available.notify_one();
+   } else {
+      impl_->reader_available.notify_one();
+   }
+}
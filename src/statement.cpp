@@ -10,14 +10,131 @@
 #include <sqlite-burrito/errors/sqlite.h>
 #include <sqlite-burrito/statement.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <iterator>
+#include <string>
+#include <vector>
 
 #include <sqlite3.h>
 
 using namespace sqlite_burrito;
 
-struct statement::parameter_map {
-   std::map<std::string_view, int> map{};
+namespace {
+
+//! FNV-1a hash
+std::uint32_t hash_of(std::string_view name) noexcept {
+   std::uint32_t hash = 2166136261u;
+   for (auto ch : name) {
+      hash ^= static_cast<std::uint8_t>(ch);
+      hash *= 16777619u;
+   }
+   return hash;
+}
+
+} // namespace
+
+struct statement::column_map {
+   struct slot {
+      //! Column name hash
+      std::uint32_t hash{0};
+
+      //! Column name location in the `names` buffer
+      std::uint32_t offset{0};
+      std::uint32_t length{0};
+
+      //! Column index, -1 for empty slots
+      int index{-1};
+   };
+
+   //! Open addressing (linear probing) hash table, the size is always a power of two
+   std::vector<slot> slots{};
+
+   //! Column names storage
+   std::string names{};
+
+   //! Statement re-prepare counter value, at the time the map was built. SQLite transparently re-prepares the
+   //! statements after schema changes, which might change the result columns (e.g. for `SELECT *`)
+   int reprepare_count{0};
+
+   void build(native_handle_t stmt) {
+      slots.clear();
+      names.clear();
+      reprepare_count = ::sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_REPREPARE, 0);
+
+      const auto count = ::sqlite3_column_count(stmt);
+
+      std::size_t capacity = 8;
+      while (capacity < static_cast<std::size_t>(count) * 2) {
+         capacity *= 2;
+      }
+      slots.resize(capacity);
+
+      const auto mask = capacity - 1;
+      for (int i = 0; i < count; ++i) {
+         const auto ptr = ::sqlite3_column_name(stmt, i);
+         if (!ptr) {
+            // Out of memory
+            continue;
+         }
+
+         const std::string_view name{ptr};
+         const auto hash = hash_of(name);
+
+         auto idx = hash & mask;
+         bool duplicate = false;
+         while (slots[idx].index != -1) {
+            if (slots[idx].hash == hash && name_of(slots[idx]) == name) {
+               // Same name used for multiple columns: the first one wins
+               duplicate = true;
+               break;
+            }
+            idx = (idx + 1) & mask;
+         }
+
+         if (duplicate) {
+            continue;
+         }
+
+         slots[idx] = slot{hash, static_cast<std::uint32_t>(names.size()), static_cast<std::uint32_t>(name.size()), i};
+         names.append(name);
+      }
+   }
+
+   [[nodiscard]] std::string_view name_of(const slot &s) const noexcept {
+      return std::string_view{names}.substr(s.offset, s.length);
+   }
+
+   [[nodiscard]] int find(std::string_view name) const noexcept {
+      const auto hash = hash_of(name);
+      const auto mask = slots.size() - 1;
+
+      for (auto idx = hash & mask;; idx = (idx + 1) & mask) {
+         const auto &s = slots[idx];
+         if (s.index == -1) {
+            return -1;
+         }
+
+         if (s.hash == hash && name_of(s) == name) {
+            return s.index;
+         }
+      }
+   }
+};
+
+struct statement::owned_values {
+   struct value {
+      value(int index, void *data, void (*deleter)(void *))
+         : index{index}
+         , data{data, deleter} {
+         // Nothing to do here
+      }
+
+      int index;
+      std::unique_ptr<void, void (*)(void *)> data;
+   };
+
+   std::vector<value> values{};
 };
 
 statement::statement(connection &conn, prepare_flags flags)
@@ -26,10 +143,73 @@ statement::statement(connection &conn, prepare_flags flags)
    // Nothing to do here
 }
 
+statement::statement(statement &&other) noexcept
+   : connection_{other.connection_}
+   , flags_{other.flags_}
+   , stmt_{std::exchange(other.stmt_, nullptr)}
+   , generation_{std::exchange(other.generation_, nullptr)}
+   , heap_parameters_{std::exchange(other.heap_parameters_, nullptr)}
+   , parameter_count_{std::exchange(other.parameter_count_, 0)}
+   , parameters_filled_{std::exchange(other.parameters_filled_, false)}
+   , columns_{std::exchange(other.columns_, nullptr)}
+   , owned_{std::exchange(other.owned_, nullptr)} {
+   // The lookup table is plain data, without any references into the statement object
+   std::copy(std::begin(other.inline_parameters_), std::end(other.inline_parameters_), std::begin(inline_parameters_));
+}
+
 statement::~statement() {
-   delete parameters_;
+   destroy();
+}
+
+statement &statement::operator=(statement &&other) noexcept {
+   if (this != &other) {
+      destroy();
+
+      connection_ = other.connection_;
+      flags_ = other.flags_;
+      stmt_ = std::exchange(other.stmt_, nullptr);
+      generation_ = std::exchange(other.generation_, nullptr);
+
+      std::copy(std::begin(other.inline_parameters_), std::end(other.inline_parameters_),
+                std::begin(inline_parameters_));
+      heap_parameters_ = std::exchange(other.heap_parameters_, nullptr);
+      parameter_count_ = std::exchange(other.parameter_count_, 0);
+      parameters_filled_ = std::exchange(other.parameters_filled_, false);
 
+      columns_ = std::exchange(other.columns_, nullptr);
+      owned_ = std::exchange(other.owned_, nullptr);
+   }
+   return *this;
+}
+
+void statement::destroy() noexcept {
+   clear_parameters_map();
+
+   delete columns_;
+   columns_ = nullptr;
+
+   // Finalize first: SQLite is still referencing the owned values until then
    ::sqlite3_finalize(stmt_);
+   stmt_ = nullptr;
+
+   delete owned_;
+   owned_ = nullptr;
+
+   delete generation_;
+   generation_ = nullptr;
+}
+
+void statement::invalidate_views() noexcept {
+   if (generation_) {
+      ++*generation_;
+   }
+}
+
+const std::uint64_t *statement::view_generation() {
+   if (!generation_) {
+      generation_ = new std::uint64_t{0};
+   }
+   return generation_;
 }
 
 statement::iterator_t statement::prepare(std::string_view text) {
@@ -52,6 +232,14 @@ statement::iterator_t statement::prepare(std::string_view text, std::error_code
    if (!ec && new_statement) {
       ::sqlite3_finalize(stmt_);
       stmt_ = new_statement;
+      invalidate_views();
+
+      // Parameter and column names are no longer valid
+      clear_parameters_map();
+      if (columns_) {
+         delete columns_;
+         columns_ = nullptr;
+      }
    }
 
    auto distance = std::distance(text.data(), tail);
@@ -124,33 +312,50 @@ void statement::reset() {
 }
 
 void statement::reset(std::error_code &ec) {
+   invalidate_views();
    ec = errors::make_error_code(::sqlite3_reset(stmt_));
 }
 
-bool statement::step() {
+void statement::clear_bindings() {
    std::error_code ec;
-   bool result = step(ec);
-
-   if (result) {
-      return true;
+   clear_bindings(ec);
+   if (ec) {
+      throw std::system_error(ec);
    }
+}
 
-   if (ec == errors::condition::done) {
-      // Statement is done - no more data available, but it is still not an error
-      return false;
+void statement::clear_bindings(std::error_code &ec) {
+   ec = errors::make_error_code(::sqlite3_clear_bindings(stmt_));
+
+   // Nothing is referencing the owned values anymore
+   if (owned_) {
+      owned_->values.clear();
    }
+}
+
+bool statement::step() {
+   std::error_code ec;
+   bool result = step(ec);
 
    if (ec) {
       // Neither a row is available, nor was the step finished: it's an error
       throw std::system_error(ec);
-   } else {
-      return false;
    }
+
+   return result;
 }
 
-bool statement::step(std::error_code ec) {
+bool statement::step(std::error_code &ec) {
+   invalidate_views();
    ec = errors::make_error_code(::sqlite3_step(stmt_));
-   return (ec == errors::condition::row);
+
+   const bool have_row = (ec == errors::condition::row);
+   if (have_row || ec == errors::condition::done) {
+      // Not an error
+      ec = errors::code::ok;
+   }
+
+   return have_row;
 }
 
 int statement::execute() {
@@ -165,49 +370,165 @@ int statement::execute() {
 }
 
 int statement::execute(std::error_code &ec) {
-   step(ec);
-
-   if (ec == errors::condition::done) {
-      return ::sqlite3_changes(&connection_->native_handle());
+   if (step(ec) || ec) {
+      return 0;
    }
 
-   return 0;
+   return ::sqlite3_changes(&connection_->native_handle());
 }
 
 void statement::fill_parameters_map() {
-   if (parameters_) {
-      // Already filled up
+   if (parameters_filled_) {
       return;
    }
 
-   // Construct default map
-   parameters_ = new parameter_map();
-   auto &map = parameters_->map;
-
-   // Fill the map
+   // Count the named parameters first, to decide on the storage
    const auto max_index = ::sqlite3_bind_parameter_count(stmt_);
+
+   std::size_t count = 0;
    for (int i = 1; i <= max_index; ++i) {
-      const auto ptr = sqlite3_bind_parameter_name(stmt_, i);
+      if (::sqlite3_bind_parameter_name(stmt_, i)) {
+         ++count;
+      }
+   }
+
+   auto slots = inline_parameters_;
+   if (count > inline_parameter_count) {
+      heap_parameters_ = new parameter_slot[count];
+      slots = heap_parameters_;
+   }
+
+   std::size_t filled = 0;
+   for (int i = 1; i <= max_index && filled < count; ++i) {
+      const auto ptr = ::sqlite3_bind_parameter_name(stmt_, i);
       if (!ptr) {
          // Either out of range, or a nameless parameter
          continue;
       }
 
-      map[ptr] = i;
+      const std::string_view name{ptr};
+      slots[filled++] = parameter_slot{hash_of(name), i, name.size()};
    }
+
+   std::sort(slots, slots + filled, [](const auto &lhs, const auto &rhs) { return lhs.hash < rhs.hash; });
+
+   parameter_count_ = filled;
+   parameters_filled_ = true;
+}
+
+void statement::clear_parameters_map() noexcept {
+   delete[] heap_parameters_;
+   heap_parameters_ = nullptr;
+
+   parameter_count_ = 0;
+   parameters_filled_ = false;
 }
 
 std::optional<int> statement::find_parameter_by_name(std::string_view name) {
-   if (!parameters_) {
-      fill_parameters_map();
+   fill_parameters_map();
+
+   const auto hash = hash_of(name);
+   const auto begin = heap_parameters_ ? heap_parameters_ : inline_parameters_;
+   const auto end = begin + parameter_count_;
+
+   auto it = begin;
+   if (parameter_count_ > inline_parameter_count) {
+      it = std::lower_bound(begin, end, hash, [](const auto &slot, std::uint32_t h) { return slot.hash < h; });
+   }
+
+   for (; it != end && it->hash <= hash; ++it) {
+      if (it->hash != hash || it->length != name.size()) {
+         continue;
+      }
+
+      // Parameter indices are stable across the re-preparations, the names are not
+      const auto current = ::sqlite3_bind_parameter_name(stmt_, it->index);
+      if (current && std::string_view{current} == name) {
+         return it->index;
+      }
    }
 
-   auto it = parameters_->map.find(name);
-   if (it == parameters_->map.end()) {
+   return {};
+}
+
+statement::parameter_handle statement::param(std::string_view name) {
+   std::error_code ec;
+   auto result = param(name, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+   return result;
+}
+
+statement::parameter_handle statement::param(std::string_view name, std::error_code &ec) {
+   auto optional_idx = find_parameter_by_name(name);
+   if (!optional_idx) {
+      ec = std::make_error_code(std::errc::invalid_argument);
       return {};
    }
 
-   return it->second;
+   return parameter_handle{*optional_idx};
+}
+
+void statement::bind_null(parameter_handle param) {
+   std::error_code ec;
+   bind_null(param, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void statement::bind_null(parameter_handle param, std::error_code &ec) {
+   bind_null(param.index, ec);
+}
+
+std::optional<int> statement::find_column(std::string_view name) {
+   if (!stmt_) {
+      return {};
+   }
+
+   if (!columns_) {
+      columns_ = new column_map();
+      columns_->build(stmt_);
+   } else if (columns_->reprepare_count != ::sqlite3_stmt_status(stmt_, SQLITE_STMTSTATUS_REPREPARE, 0)) {
+      columns_->build(stmt_);
+   }
+
+   auto index = columns_->find(name);
+   if (index < 0) {
+      return {};
+   }
+
+   return index;
+}
+
+void statement::keep_alive(int index, void *value, void (*deleter)(void *)) {
+   if (!owned_) {
+      owned_ = new owned_values();
+   }
+
+   auto &values = owned_->values;
+   for (auto &v : values) {
+      if (v.index == index) {
+         // The previous value is no longer needed: SQLite is referencing the new one
+         v.data.reset(value);
+         v.data.get_deleter() = deleter;
+         return;
+      }
+   }
+
+   values.emplace_back(index, value, deleter);
+}
+
+void statement::release_owned(int index, const std::error_code &ec) noexcept {
+   if (ec || !owned_) {
+      // SQLite is still referencing the previous value
+      return;
+   }
+
+   auto &values = owned_->values;
+   values.erase(std::remove_if(values.begin(), values.end(), [index](const auto &v) { return v.index == index; }),
+                values.end());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -223,6 +544,20 @@ void statement::bind_null(int index) {
 
 void statement::bind_null(int index, std::error_code &ec) {
    ec = errors::make_error_code(::sqlite3_bind_null(stmt_, index));
+   release_owned(index, ec);
+}
+
+void statement::bind_zeroblob(int index, std::size_t size) {
+   std::error_code ec;
+   bind_zeroblob(index, size, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void statement::bind_zeroblob(int index, std::size_t size, std::error_code &ec) {
+   ec = errors::make_error_code(::sqlite3_bind_zeroblob64(stmt_, index, static_cast<sqlite3_uint64>(size)));
+   release_owned(index, ec);
 }
 
 void statement::bind(int index, const void *blob, std::size_t size) {
@@ -236,56 +571,119 @@ void statement::bind(int index, const void *blob, std::size_t size) {
 void statement::bind(int index, float value, std::error_code &ec) {
    double double_value = static_cast<double>(value);
    ec = errors::make_error_code(::sqlite3_bind_double(stmt_, index, double_value));
+   release_owned(index, ec);
 }
 
 void statement::bind(int index, double value, std::error_code &ec) {
    ec = errors::make_error_code(::sqlite3_bind_double(stmt_, index, value));
+   release_owned(index, ec);
 }
 
 void statement::bind(int index, bool value, std::error_code &ec) {
    int int_value = value ? 1 : 0;
    ec = errors::make_error_code(::sqlite3_bind_int(stmt_, index, int_value));
+   release_owned(index, ec);
 }
 
 void statement::bind(int index, std::int8_t value, std::error_code &ec) {
    ec = errors::make_error_code(::sqlite3_bind_int(stmt_, index, value));
+   release_owned(index, ec);
 }
 
 void statement::bind(int index, std::int16_t value, std::error_code &ec) {
    ec = errors::make_error_code(::sqlite3_bind_int(stmt_, index, value));
+   release_owned(index, ec);
 }
 
 void statement::bind(int index, std::int32_t value, std::error_code &ec) {
    ec = errors::make_error_code(::sqlite3_bind_int(stmt_, index, value));
+   release_owned(index, ec);
 }
 
 void statement::bind(int index, std::int64_t value, std::error_code &ec) {
    ec = errors::make_error_code(::sqlite3_bind_int64(stmt_, index, value));
+   release_owned(index, ec);
 }
 
 void statement::bind(int index, std::uint8_t value, std::error_code &ec) {
    ec = errors::make_error_code(::sqlite3_bind_int(stmt_, index, value));
+   release_owned(index, ec);
 }
 
 void statement::bind(int index, std::uint16_t value, std::error_code &ec) {
    ec = errors::make_error_code(::sqlite3_bind_int(stmt_, index, value));
+   release_owned(index, ec);
 }
 
 void statement::bind(int index, std::uint32_t value, std::error_code &ec) {
    ec = errors::make_error_code(::sqlite3_bind_int(stmt_, index, static_cast<std::int32_t>(value)));
+   release_owned(index, ec);
 }
 
 void statement::bind(int index, std::uint64_t value, std::error_code &ec) {
    ec = errors::make_error_code(::sqlite3_bind_int64(stmt_, index, static_cast<std::int64_t>(value)));
+   release_owned(index, ec);
 }
 
 void statement::bind(int index, std::string_view value, std::error_code &ec) {
    ec = errors::make_error_code(
        ::sqlite3_bind_text(stmt_, index, value.data(), static_cast<int>(value.size()), SQLITE_TRANSIENT));
+   release_owned(index, ec);
 }
 
 void statement::bind(int index, const void *blob, std::size_t size, std::error_code &ec) {
    ec = errors::make_error_code(::sqlite3_bind_blob64(stmt_, index, blob, size, SQLITE_TRANSIENT));
+   release_owned(index, ec);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Index-based zero-copy binds
+////////////////////////////////////////////////////////////////////////////////
+void statement::bind_static(int index, std::string_view value) {
+   std::error_code ec;
+   bind_static(index, value, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void statement::bind_static(int index, std::string_view value, std::error_code &ec) {
+   ec = errors::make_error_code(
+       ::sqlite3_bind_text(stmt_, index, value.data(), static_cast<int>(value.size()), SQLITE_STATIC));
+   release_owned(index, ec);
+}
+
+void statement::bind_static(int index, const void *blob, std::size_t size) {
+   std::error_code ec;
+   bind_static(index, blob, size, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void statement::bind_static(int index, const void *blob, std::size_t size, std::error_code &ec) {
+   ec = errors::make_error_code(::sqlite3_bind_blob64(stmt_, index, blob, size, SQLITE_STATIC));
+   release_owned(index, ec);
+}
+
+void statement::bind_owned(int index, std::string &&value) {
+   std::error_code ec;
+   bind_owned(index, std::move(value), ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void statement::bind_owned(int index, std::string &&value, std::error_code &ec) {
+   auto owned = std::make_unique<std::string>(std::move(value));
+
+   // On failures SQLite is still referencing the previous value, so it's only replaced after a successful bind
+   bind_static(index, *owned, ec);
+   if (ec) {
+      return;
+   }
+
+   keep_alive(index, owned.release(), [](void *ptr) { delete static_cast<std::string *>(ptr); });
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -309,6 +707,81 @@ void statement::bind_null(std::string_view name, std::error_code &ec) {
    bind_null(*optional_idx, ec);
 }
 
+void statement::bind_zeroblob(std::string_view name, std::size_t size) {
+   std::error_code ec;
+   bind_zeroblob(name, size, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void statement::bind_zeroblob(std::string_view name, std::size_t size, std::error_code &ec) {
+   auto optional_idx = find_parameter_by_name(name);
+   if (!optional_idx) {
+      ec = std::make_error_code(std::errc::invalid_argument);
+      return;
+   }
+
+   bind_zeroblob(*optional_idx, size, ec);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Name-based zero-copy binds
+////////////////////////////////////////////////////////////////////////////////
+void statement::bind_static(std::string_view name, std::string_view value) {
+   std::error_code ec;
+   bind_static(name, value, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void statement::bind_static(std::string_view name, std::string_view value, std::error_code &ec) {
+   auto optional_idx = find_parameter_by_name(name);
+   if (!optional_idx) {
+      ec = std::make_error_code(std::errc::invalid_argument);
+      return;
+   }
+
+   bind_static(*optional_idx, value, ec);
+}
+
+void statement::bind_static(std::string_view name, const void *blob, std::size_t size) {
+   std::error_code ec;
+   bind_static(name, blob, size, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void statement::bind_static(std::string_view name, const void *blob, std::size_t size, std::error_code &ec) {
+   auto optional_idx = find_parameter_by_name(name);
+   if (!optional_idx) {
+      ec = std::make_error_code(std::errc::invalid_argument);
+      return;
+   }
+
+   bind_static(*optional_idx, blob, size, ec);
+}
+
+void statement::bind_owned(std::string_view name, std::string &&value) {
+   std::error_code ec;
+   bind_owned(name, std::move(value), ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+}
+
+void statement::bind_owned(std::string_view name, std::string &&value, std::error_code &ec) {
+   auto optional_idx = find_parameter_by_name(name);
+   if (!optional_idx) {
+      ec = std::make_error_code(std::errc::invalid_argument);
+      return;
+   }
+
+   bind_owned(*optional_idx, std::move(value), ec);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Column information
 ////////////////////////////////////////////////////////////////////////////////
@@ -483,3 +956,72 @@ void statement::get(int index, std::string &value, std::error_code &ec) {
    }
    std::copy(from, from + num_bytes, std::begin(value));
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// Index-based zero-copy getters
+////////////////////////////////////////////////////////////////////////////////
+text_view statement::get_view(int index) {
+   std::error_code ec;
+   auto result = get_view(index, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+   return result;
+}
+
+text_view statement::get_view(int index, std::error_code &ec) {
+   // Note: the pointer has to be requested before the size, otherwise the size might be of a different encoding
+   auto from = reinterpret_cast<const char *>(::sqlite3_column_text(stmt_, index));
+   if (!from) {
+      if (!is_null(index)) {
+         ec = connection_->last_error();
+         if (ec == errors::condition::row) {
+            // Spurious error - it's actually an empty value
+            ec = errors::code::ok;
+         }
+      }
+      return {};
+   }
+
+   auto num_bytes = static_cast<std::size_t>(::sqlite3_column_bytes(stmt_, index));
+   return {from, num_bytes, view_generation()};
+}
+
+blob_view statement::get_blob_view(int index) {
+   std::error_code ec;
+   auto result = get_blob_view(index, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+   return result;
+}
+
+blob_view statement::get_blob_view(int index, std::error_code &ec) {
+   auto from = reinterpret_cast<const std::byte *>(::sqlite3_column_blob(stmt_, index));
+   if (!from) {
+      // Both NULLs and empty blobs are reported as NULL pointers
+      if (!is_null(index)) {
+         ec = connection_->last_error();
+         if (ec == errors::condition::row) {
+            // Spurious error - it's actually an empty value
+            ec = errors::code::ok;
+         }
+      }
+      return {};
+   }
+
+   auto num_bytes = static_cast<std::size_t>(::sqlite3_column_bytes(stmt_, index));
+   return {from, num_bytes, view_generation()};
+}
+
+void statement::get(int index, std::string_view &value, std::error_code &ec) {
+   value = get_view(index, ec);
+}
+
+void statement::get(int index, text_view &value, std::error_code &ec) {
+   value = get_view(index, ec);
+}
+
+void statement::get(int index, blob_view &value, std::error_code &ec) {
+   value = get_blob_view(index, ec);
+}
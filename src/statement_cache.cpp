@@ -0,0 +1,238 @@
+/**
+ * @file   statement_cache.cpp
+ */
+
+#include <sqlite-burrito/connection.h>
+#include <sqlite-burrito/statement_cache.h>
+
+#include <sqlite3.h>
+
+#include <iterator>
+#include <list>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+using namespace sqlite_burrito;
+
+// The cache (owned by the connection) and its statements are referencing the connection object
+static_assert(!std::is_move_constructible_v<connection> && !std::is_move_assignable_v<connection>,
+              "Connections should not be movable");
+
+struct statement_cache::impl {
+   struct entry {
+      std::string sql;
+      std::unique_ptr<statement> stmt;
+      std::size_t bytes{0};
+
+      //! Cache generation at the time of preparing
+      std::uint64_t generation{0};
+   };
+
+   using idle_list_t = std::list<entry>;
+
+   //! Idle statements, the most recently used ones first
+   idle_list_t idle{};
+
+   //! Idle statements lookup by their SQL text (the keys are referencing the list entries)
+   std::unordered_multimap<std::string_view, idle_list_t::iterator> index{};
+
+   //! Statements, currently handed out as leases
+   std::unordered_map<statement *, entry> leased{};
+
+   limits cache_limits{};
+   statistics stats{};
+
+   //! Incremented on each `clear`, leases from the previous generations are finalized once returned
+   std::uint64_t generation{0};
+
+   void erase(idle_list_t::iterator it) {
+      auto range = index.equal_range(it->sql);
+      for (auto idx = range.first; idx != range.second; ++idx) {
+         if (idx->second == it) {
+            index.erase(idx);
+            break;
+         }
+      }
+
+      stats.size -= 1;
+      stats.bytes -= it->bytes;
+      idle.erase(it);
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Lease
+////////////////////////////////////////////////////////////////////////////////
+statement_cache::lease::lease(statement_cache *cache, statement *stmt) noexcept
+   : cache_{cache}
+   , stmt_{stmt} {
+   // Nothing to do here
+}
+
+statement_cache::lease::lease(lease &&other) noexcept
+   : cache_{other.cache_}
+   , stmt_{other.stmt_} {
+   other.cache_ = nullptr;
+   other.stmt_ = nullptr;
+}
+
+statement_cache::lease::~lease() {
+   release();
+}
+
+statement_cache::lease &statement_cache::lease::operator=(lease &&other) noexcept {
+   if (this != &other) {
+      release();
+
+      cache_ = other.cache_;
+      stmt_ = other.stmt_;
+
+      other.cache_ = nullptr;
+      other.stmt_ = nullptr;
+   }
+   return *this;
+}
+
+void statement_cache::lease::release() noexcept {
+   if (cache_ && stmt_) {
+      cache_->give_back(stmt_);
+   }
+
+   cache_ = nullptr;
+   stmt_ = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Cache
+////////////////////////////////////////////////////////////////////////////////
+statement_cache::statement_cache(connection &con)
+   : statement_cache(con, limits{}) {
+   // Nothing to do here
+}
+
+statement_cache::statement_cache(connection &con, limits limits)
+   : con_{&con}
+   , impl_{new impl()} {
+   impl_->cache_limits = limits;
+}
+
+statement_cache::~statement_cache() {
+   delete impl_;
+}
+
+statement_cache::lease statement_cache::acquire(std::string_view sql) {
+   std::error_code ec;
+   auto result = acquire(sql, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
+   return result;
+}
+
+statement_cache::lease statement_cache::acquire(std::string_view sql, std::error_code &ec) {
+   auto &idle = impl_->idle;
+   auto &index = impl_->index;
+
+   auto found = index.find(sql);
+   if (found != index.end()) {
+      auto it = found->second;
+      index.erase(found);
+
+      impl_->stats.hits += 1;
+      impl_->stats.size -= 1;
+      impl_->stats.bytes -= it->bytes;
+
+      auto stmt = it->stmt.get();
+      impl_->leased.emplace(stmt, std::move(*it));
+      idle.erase(it);
+
+      return lease{this, stmt};
+   }
+
+   impl_->stats.misses += 1;
+
+   auto stmt = std::make_unique<statement>(*con_, statement::prepare_flags::persistent);
+   stmt->prepare(sql, ec);
+   if (ec) {
+      return {};
+   }
+
+   if (!stmt->is_prepared()) {
+      // Empty SQL text or a comment, there is nothing to execute (or to cache)
+      ec = std::make_error_code(std::errc::invalid_argument);
+      return {};
+   }
+
+   auto ptr = stmt.get();
+   impl_->leased.emplace(ptr, impl::entry{std::string{sql}, std::move(stmt), 0, impl_->generation});
+   return lease{this, ptr};
+}
+
+void statement_cache::clear() noexcept {
+   impl_->generation += 1;
+   impl_->index.clear();
+   impl_->idle.clear();
+   impl_->stats.size = 0;
+   impl_->stats.bytes = 0;
+}
+
+void statement_cache::set_limits(limits limits) {
+   impl_->cache_limits = limits;
+   enforce_limits();
+}
+
+statement_cache::limits statement_cache::get_limits() const noexcept {
+   return impl_->cache_limits;
+}
+
+statement_cache::statistics statement_cache::stats() const noexcept {
+   return impl_->stats;
+}
+
+void statement_cache::give_back(statement *stmt) noexcept {
+   auto leased = impl_->leased.find(stmt);
+   if (leased == impl_->leased.end()) {
+      // Not one of ours (e.g. the cache was cleared in the meantime)
+      return;
+   }
+
+   auto entry = std::move(leased->second);
+   impl_->leased.erase(leased);
+
+   if (entry.generation != impl_->generation) {
+      // Leased out before the cache was cleared, and might belong to an already closed connection
+      return;
+   }
+
+   std::error_code ec;
+   entry.stmt->reset(ec);
+   entry.stmt->clear_bindings(ec);
+
+   entry.bytes = static_cast<std::size_t>(
+       ::sqlite3_stmt_status(&entry.stmt->native_handle(), SQLITE_STMTSTATUS_MEMUSED, 0));
+
+   auto &idle = impl_->idle;
+   idle.push_front(std::move(entry));
+
+   auto it = idle.begin();
+   impl_->index.emplace(it->sql, it);
+   impl_->stats.size += 1;
+   impl_->stats.bytes += it->bytes;
+
+   enforce_limits();
+}
+
+void statement_cache::enforce_limits() noexcept {
+   const auto &limits = impl_->cache_limits;
+   auto &stats = impl_->stats;
+
+   auto over_limits = [&] {
+      return stats.size > limits.max_statements || (limits.max_bytes != 0 && stats.bytes > limits.max_bytes);
+   };
+
+   while (!impl_->idle.empty() && over_limits()) {
+      impl_->erase(std::prev(impl_->idle.end()));
+      stats.evictions += 1;
+   }
+}
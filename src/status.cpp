@@ -0,0 +1,32 @@
+/**
+ * @file   status.cpp
+ */
+
+#include <sqlite-burrito/status.h>
+
+#include <sqlite3.h>
+
+using namespace sqlite_burrito;
+
+namespace {
+
+status_counter read_status(int op, bool reset) {
+   sqlite3_int64 current = 0;
+   sqlite3_int64 highwater = 0;
+   ::sqlite3_status64(op, &current, &highwater, reset ? 1 : 0);
+   return status_counter{current, highwater};
+}
+
+} // namespace
+
+global_statistics sqlite_burrito::global_stats(bool reset_highwater) noexcept {
+   global_statistics result;
+   result.memory_used = read_status(SQLITE_STATUS_MEMORY_USED, reset_highwater);
+   result.malloc_count = read_status(SQLITE_STATUS_MALLOC_COUNT, reset_highwater);
+   result.malloc_size = read_status(SQLITE_STATUS_MALLOC_SIZE, reset_highwater);
+   result.pagecache_used = read_status(SQLITE_STATUS_PAGECACHE_USED, reset_highwater);
+   result.pagecache_overflow = read_status(SQLITE_STATUS_PAGECACHE_OVERFLOW, reset_highwater);
+   result.pagecache_size = read_status(SQLITE_STATUS_PAGECACHE_SIZE, reset_highwater);
+   result.parser_stack = read_status(SQLITE_STATUS_PARSER_STACK, reset_highwater);
+   return result;
+}
@@ -5,31 +5,49 @@
  */
 
 #include <sqlite-burrito/transaction.h>
-#include <sqlite-burrito/statement.h>
+#include <sqlite-burrito/connection.h>
 
 using namespace sqlite_burrito;
 
 transaction::transaction(connection &con, behavior behavior)
    : con_{&con} {
-   const char *stmt;
+   std::error_code ec;
+
+   if (::sqlite3_get_autocommit(&con_->native_handle()) == 0) {
+      // Already inside a transaction: start a nested one
+      const auto depth = con_->savepoint_depth_ + 1;
+      con_->execute_savepoint_control(connection::savepoint_control::begin, depth, ec);
+      if (ec) {
+         throw std::system_error(ec);
+      }
+
+      con_->savepoint_depth_ = depth;
+      savepoint_ = depth;
+      return;
+   }
+
+   connection::control stmt;
    switch (behavior) {
       case behavior::deferred:
-         stmt = "BEGIN DEFERRED";
+         stmt = connection::control::begin_deferred;
          break;
 
       case behavior::immediate:
-         stmt = "BEGIN IMMEDIATE";
+         stmt = connection::control::begin_immediate;
          break;
 
       case behavior::exclusive:
-         stmt = "BEGIN EXCLUSIVE";
+         stmt = connection::control::begin_exclusive;
          break;
 
       default:
          throw std::system_error(std::make_error_code(std::errc::invalid_argument));
    }
 
-   statement::execute(*con_, stmt);
+   con_->execute_control(stmt, ec);
+   if (ec) {
+      throw std::system_error(ec);
+   }
 }
 
 transaction::~transaction() {
@@ -37,8 +55,10 @@ transaction::~transaction() {
       return;
    }
 
-   // TODO: Handle rollback errors to avoid throwing from the destructor?
-   statement::execute(*con_, "ROLLBACK TRANSACTION");
+   // Errors cannot be reported from the destructor (throwing here would terminate the program), and a failed
+   // rollback leaves nothing else to be done.
+   std::error_code ec;
+   end(false, ec);
 }
 
 void transaction::commit() {
@@ -55,8 +75,10 @@ void transaction::commit(std::error_code &ec) noexcept {
       return;
    }
 
-   statement::execute(*con_, "COMMIT TRANSACTION", ec);
-   committed_ = true;
+   end(true, ec);
+
+   // A failed commit (e.g. because of SQLITE_BUSY) leaves the transaction open: it can be retried or rolled back
+   committed_ = !ec;
 }
 
 void transaction::rollback() {
@@ -73,6 +95,40 @@ void transaction::rollback(std::error_code &ec) noexcept {
       return;
    }
 
-   statement::execute(*con_, "ROLLBACK TRANSACTION", ec);
+   end(false, ec);
    rolled_back_ = true;
 }
+
+void transaction::end(bool commit, std::error_code &ec) noexcept {
+   if (!savepoint_) {
+      con_->execute_control(commit ? connection::control::commit : connection::control::rollback, ec);
+
+      // Any savepoints are gone together with the outermost transaction
+      update_savepoint_depth(0, ec);
+      return;
+   }
+
+   if (!commit) {
+      // Rolling back to a savepoint doesn't remove it from the transaction stack, it still has to be released
+      con_->execute_savepoint_control(connection::savepoint_control::rollback, savepoint_, ec);
+      if (ec) {
+         return;
+      }
+   }
+
+   con_->execute_savepoint_control(connection::savepoint_control::release, savepoint_, ec);
+
+   // Releasing a savepoint also releases all the savepoints nested in it
+   update_savepoint_depth(savepoint_ - 1, ec);
+}
+
+void transaction::update_savepoint_depth(int depth, const std::error_code &ec) noexcept {
+   if (!ec) {
+      con_->savepoint_depth_ = depth;
+   } else if (::sqlite3_get_autocommit(&con_->native_handle()) != 0) {
+      // The statement failed, but the whole transaction is gone anyway (e.g. rolled back by SQLite)
+      con_->savepoint_depth_ = 0;
+   }
+
+   // Otherwise the savepoints are still on the stack, and their names should not be reused
+}
@@ -0,0 +1,165 @@
+/**
+ * @file   async_connection.cpp
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sqlite-burrito/async_connection.h>
+#include <sqlite-burrito/errors/sqlite.h>
+#include <sqlite-burrito/statement.h>
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+using namespace sqlite_burrito;
+
+namespace {
+
+std::int64_t count_rows(connection &con) {
+   statement stmt{con};
+   stmt.prepare("SELECT COUNT(*) FROM test;");
+   stmt.step();
+
+   std::int64_t result = 0;
+   stmt.get(0, result);
+   return result;
+}
+
+} // namespace
+
+TEST_CASE("Async jobs should run on the worker thread in order", "[async_connection]") {
+   async_connection db;
+   REQUIRE_NOTHROW(db.open(":memory:").get());
+   REQUIRE_FALSE(db.on_worker_thread());
+
+   auto created = db.submit([](connection &con) {
+      statement::execute(con, "CREATE TABLE test(value INTEGER);");
+      return std::this_thread::get_id();
+   });
+
+   std::vector<std::future<void>> inserts;
+   for (int i = 0; i < 10; ++i) {
+      inserts.push_back(db.submit([i](connection &con) {
+         statement stmt{con};
+         stmt.prepare("INSERT INTO test(value) VALUES (:pvalue);");
+         stmt.bind(":pvalue", i);
+         stmt.execute();
+      }));
+   }
+
+   auto values = db.submit([](connection &con) {
+      std::vector<int> result;
+      statement stmt{con};
+      stmt.prepare("SELECT value FROM test ORDER BY rowid;");
+      while (stmt.step()) {
+         int value = 0;
+         stmt.get(0, value);
+         result.push_back(value);
+      }
+      return result;
+   });
+
+   REQUIRE(created.get() != std::this_thread::get_id());
+   for (auto &insert : inserts) {
+      REQUIRE_NOTHROW(insert.get());
+   }
+   REQUIRE(values.get() == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+
+   SECTION("Exceptions are delivered via the futures") {
+      auto failed = db.submit([](connection &con) { statement::execute(con, "SELECT * FROM missing;"); });
+      REQUIRE_THROWS_AS(failed.get(), std::system_error);
+
+      // The worker keeps going
+      REQUIRE(db.submit(count_rows).get() == 10);
+   }
+
+   SECTION("Completion callbacks") {
+      std::promise<std::pair<std::error_code, std::int64_t>> done;
+      db.submit(
+          [](connection &con, std::error_code &ec) {
+             statement::execute(con, "INSERT INTO test(value) VALUES (10);", ec);
+             return ec ? -1 : count_rows(con);
+          },
+          [&](std::error_code ec, std::int64_t count) { done.set_value({ec, count}); });
+
+      auto [ec, count] = done.get_future().get();
+      REQUIRE_FALSE(ec);
+      REQUIRE(count == 11);
+
+      std::promise<std::error_code> failed;
+      db.submit([](connection &con, std::error_code &ec) { statement::execute(con, "SELECT * FROM missing;", ec); },
+                [&](std::error_code ec) { failed.set_value(ec); });
+      REQUIRE(failed.get_future().get() == errors::condition::error);
+   }
+
+   SECTION("Follow-up jobs") {
+      std::promise<std::int64_t> done;
+      bool on_worker = false;
+      db.post([&](connection &) {
+         on_worker = db.on_worker_thread();
+         db.post([&](connection &con) { done.set_value(count_rows(con)); });
+      });
+      REQUIRE(done.get_future().get() == 10);
+      REQUIRE(on_worker);
+   }
+}
+
+TEST_CASE("Async queue should apply backpressure", "[async_connection]") {
+   async_connection::options opts;
+   opts.queue_capacity = 2;
+
+   async_connection db{opts};
+   REQUIRE_NOTHROW(db.open(":memory:").get());
+
+   // Keep the worker busy
+   std::promise<void> release;
+   auto blocker = release.get_future().share();
+   auto started = std::make_shared<std::promise<void>>();
+   db.post([blocker, started](connection &) {
+      started->set_value();
+      blocker.wait();
+   });
+   started->get_future().wait();
+
+   std::error_code ec;
+   auto first = db.try_submit([](connection &) { return 1; }, ec);
+   REQUIRE_FALSE(ec);
+   auto second = db.try_submit([](connection &) { return 2; }, ec);
+   REQUIRE_FALSE(ec);
+   REQUIRE(db.pending() == 2);
+
+   auto rejected = db.try_submit([](connection &) { return 3; }, ec);
+   REQUIRE(ec == std::errc::resource_unavailable_try_again);
+   REQUIRE_FALSE(rejected.valid());
+   ec.clear();
+
+   bool called = false;
+   db.try_submit([](connection &, std::error_code &) {}, [&](std::error_code) { called = true; }, ec);
+   REQUIRE(ec == std::errc::resource_unavailable_try_again);
+   ec.clear();
+
+   // Blocking submissions wait for the space
+   auto waiting = std::async(std::launch::async, [&] { return db.submit([](connection &) { return 4; }).get(); });
+   REQUIRE(waiting.wait_for(std::chrono::milliseconds{50}) == std::future_status::timeout);
+
+   release.set_value();
+   REQUIRE(first.get() == 1);
+   REQUIRE(second.get() == 2);
+   REQUIRE(waiting.get() == 4);
+   REQUIRE_FALSE(called);
+
+   SECTION("Stopping") {
+      auto last = db.submit([](connection &) { return 5; });
+      db.stop();
+      REQUIRE(last.get() == 5);
+
+      db.try_post([](connection &) {}, ec);
+      REQUIRE(ec == std::errc::operation_canceled);
+      REQUIRE_THROWS_AS(db.submit([](connection &) {}), std::system_error);
+   }
+}
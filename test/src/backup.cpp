@@ -0,0 +1,179 @@
+/**
+ * @file   backup.cpp
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sqlite-burrito/backup.h>
+#include <sqlite-burrito/connection.h>
+#include <sqlite-burrito/errors/sqlite.h>
+#include <sqlite-burrito/statement.h>
+
+#include <chrono>
+#include <filesystem>
+#include <system_error>
+#include <thread>
+
+using namespace sqlite_burrito;
+
+namespace {
+
+class backup_test {
+public:
+   backup_test() {
+      source_.open(":memory:");
+      destination_.open(":memory:");
+
+      // Small pages, so that the backup takes multiple steps
+      statement::execute(source_, "PRAGMA page_size = 512;");
+      statement::execute(source_,
+                         "CREATE TABLE test(value TEXT);"
+                         "WITH RECURSIVE r(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM r WHERE x < 1000) "
+                         "INSERT INTO test SELECT printf('%0100d', x) FROM r;");
+   }
+
+protected:
+   static int count_rows(connection &con, std::error_code &ec) {
+      statement stmt{con};
+      stmt.prepare("SELECT COUNT(*) FROM test;", ec);
+      if (ec) {
+         return -1;
+      }
+      stmt.step(ec);
+
+      int result = -1;
+      stmt.get(0, result, ec);
+      return result;
+   }
+
+protected:
+   connection source_{};
+   connection destination_{};
+};
+
+} // namespace
+
+TEST_CASE_METHOD(backup_test, "Backups should copy the whole database in steps", "[backup]") {
+   backup::options opts;
+   opts.pages_per_step = 10;
+   opts.step_delay = std::chrono::milliseconds{0};
+
+   backup copy{source_, destination_, opts};
+
+   int num_calls = 0;
+   backup::progress last{};
+   REQUIRE_NOTHROW(copy.run([&](const backup::progress &progress) {
+      REQUIRE(progress.remaining <= progress.total);
+      REQUIRE(progress.fraction() >= last.fraction());
+
+      last = progress;
+      ++num_calls;
+      return true;
+   }));
+
+   REQUIRE(num_calls > 5);
+   REQUIRE(last.remaining == 0);
+   REQUIRE(last.fraction() == 1.0);
+
+   std::error_code ec;
+   REQUIRE(count_rows(destination_, ec) == 1000);
+   REQUIRE(!ec);
+}
+
+TEST_CASE_METHOD(backup_test, "Backups should be cancellable", "[backup]") {
+   backup::options opts;
+   opts.pages_per_step = 1;
+   opts.step_delay = std::chrono::milliseconds{1};
+
+   backup copy{source_, destination_, opts};
+
+   SECTION("Using the callback") {
+      std::error_code ec;
+      copy.run([](const backup::progress &) { return false; }, ec);
+      REQUIRE(ec == std::errc::operation_canceled);
+   }
+
+   SECTION("From another thread") {
+      std::thread canceller{[&] {
+         std::this_thread::sleep_for(std::chrono::milliseconds{5});
+         copy.cancel();
+      }};
+
+      std::error_code ec;
+      copy.run({}, ec);
+      canceller.join();
+
+      REQUIRE(ec == std::errc::operation_canceled);
+      REQUIRE(copy.get_progress().remaining > 0);
+   }
+
+   // The destination should be left untouched
+   std::error_code ec;
+   count_rows(destination_, ec);
+   REQUIRE(ec);
+}
+
+TEST_CASE_METHOD(backup_test, "Source changes should be picked up", "[backup]") {
+   backup::options opts;
+   opts.pages_per_step = 10;
+   opts.step_delay = std::chrono::milliseconds{0};
+
+   backup copy{source_, destination_, opts};
+
+   bool inserted = false;
+   REQUIRE_NOTHROW(copy.run([&](const backup::progress &) {
+      if (!inserted) {
+         statement::execute(source_, "INSERT INTO test(value) VALUES ('extra');");
+         inserted = true;
+      }
+      return true;
+   }));
+
+   std::error_code ec;
+   REQUIRE(count_rows(destination_, ec) == 1001);
+}
+
+TEST_CASE_METHOD(backup_test, "Locked destinations should be retried with a back-off", "[backup]") {
+   const auto path = (std::filesystem::temp_directory_path() / "sqlite-burrito-backup-test.db").string();
+   std::filesystem::remove(path);
+
+   {
+      connection destination;
+      REQUIRE_NOTHROW(destination.open(path));
+
+      connection locker;
+      REQUIRE_NOTHROW(locker.open(path));
+      REQUIRE_NOTHROW(statement::execute(locker, "BEGIN EXCLUSIVE;"));
+
+      backup::options opts;
+      opts.step_delay = std::chrono::milliseconds{0};
+      opts.max_busy_retries = 5;
+
+      backup copy{source_, destination, opts};
+
+      int num_calls = 0;
+      std::error_code ec;
+      const auto started = std::chrono::steady_clock::now();
+      copy.run(
+         [&](const backup::progress &) {
+            ++num_calls;
+            return true;
+         },
+         ec);
+      const auto elapsed = std::chrono::steady_clock::now() - started;
+
+      REQUIRE(ec == errors::condition::busy);
+      REQUIRE(num_calls == opts.max_busy_retries);
+      REQUIRE(elapsed >= opts.max_busy_retries * std::chrono::milliseconds{1});
+
+      // Should succeed once the lock is released
+      REQUIRE_NOTHROW(statement::execute(locker, "COMMIT;"));
+      REQUIRE_NOTHROW(copy.run());
+
+      ec.clear();
+      REQUIRE(count_rows(destination, ec) == 1000);
+      REQUIRE(!ec);
+   }
+
+   std::filesystem::remove(path);
+}
@@ -0,0 +1,138 @@
+/**
+ * @file   blob_stream.cpp
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sqlite-burrito/blob_stream.h>
+#include <sqlite-burrito/connection.h>
+#include <sqlite-burrito/statement.h>
+
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+using namespace sqlite_burrito;
+
+namespace {
+
+class blob_stream_test {
+public:
+   blob_stream_test() {
+      con_.open(":memory:");
+      statement::execute(con_, "CREATE TABLE attachments(id INTEGER PRIMARY KEY, data BLOB);");
+   }
+
+protected:
+   std::int64_t insert_zeroblob(std::size_t size) {
+      statement insert{con_};
+      insert.prepare("INSERT INTO attachments(data) VALUES (:pdata);");
+      insert.bind_zeroblob(":pdata", size);
+      insert.execute();
+      return con_.last_insert_rowid();
+   }
+
+   static std::string make_payload(std::size_t size) {
+      std::string result(size, '\0');
+      for (std::size_t i = 0; i < size; ++i) {
+         result[i] = static_cast<char>((i * 31 + i / 1024) & 0xFF);
+      }
+      return result;
+   }
+
+protected:
+   connection con_{};
+};
+
+} // namespace
+
+TEST_CASE_METHOD(blob_stream_test, "Large blobs should be streamed in chunks", "[blob_stream]") {
+   const std::size_t size = 3 * 1024 * 1024 + 123;
+   const auto payload = make_payload(size);
+   const auto rowid = insert_zeroblob(size);
+
+   blob_stream blob{con_};
+   REQUIRE_NOTHROW(blob.open("attachments", "data", rowid, blob_stream::mode::read_write));
+   REQUIRE(blob.is_open());
+   REQUIRE(blob.size() == size);
+
+   std::istringstream input{payload};
+   REQUIRE_NOTHROW(blob.write_from(input, 64 * 1024));
+   REQUIRE(blob.tell() == size);
+
+   SECTION("Reading into a stream") {
+      blob.seek(0);
+      std::ostringstream output;
+      REQUIRE_NOTHROW(blob.read_into(output, 10000));
+      REQUIRE(output.str() == payload);
+   }
+
+   SECTION("Reading with a fixed buffer") {
+      blob_stream reader{con_};
+      REQUIRE_NOTHROW(reader.open("attachments", "data", rowid));
+
+      std::vector<char> chunk(4096);
+      std::string result;
+      std::size_t num_read;
+      while ((num_read = reader.read(chunk.data(), chunk.size())) > 0) {
+         result.append(chunk.data(), num_read);
+      }
+      REQUIRE(result == payload);
+   }
+
+   SECTION("Regular getters should see the same data") {
+      statement select{con_};
+      REQUIRE_NOTHROW(select.prepare("SELECT data FROM attachments WHERE id = :pid;"));
+      REQUIRE_NOTHROW(select.bind(":pid", rowid));
+      REQUIRE(select.step());
+
+      auto view = select.get_blob_view(0);
+      REQUIRE(std::string(reinterpret_cast<const char *>(view.data()), view.size()) == payload);
+   }
+}
+
+TEST_CASE_METHOD(blob_stream_test, "Blob streams should report errors", "[blob_stream]") {
+   const auto first = insert_zeroblob(16);
+   const auto second = insert_zeroblob(32);
+
+   blob_stream blob{con_};
+
+   std::error_code ec;
+   char data[64]{};
+   REQUIRE(blob.read(data, sizeof(data), ec) == 0);
+   REQUIRE(ec == std::errc::bad_file_descriptor);
+
+   ec.clear();
+   blob.open("attachments", "missing", first, blob_stream::mode::read_only, ec);
+   REQUIRE(ec);
+   REQUIRE(!blob.is_open());
+
+   REQUIRE_THROWS_AS(blob.open("attachments", "data", 100), std::system_error);
+
+   REQUIRE_NOTHROW(blob.open("attachments", "data", first, blob_stream::mode::read_write));
+
+   ec.clear();
+   blob.write(data, sizeof(data), ec);
+   REQUIRE(ec == std::errc::no_buffer_space);
+
+   SECTION("Reopening another row") {
+      REQUIRE_NOTHROW(blob.reopen(second));
+      REQUIRE(blob.size() == 32);
+      REQUIRE(blob.tell() == 0);
+      REQUIRE(blob.read(data, sizeof(data)) == 32);
+   }
+
+   SECTION("Read-only blobs should not be writable") {
+      REQUIRE_NOTHROW(blob.open("attachments", "data", first));
+      REQUIRE_THROWS_AS(blob.write(data, 4), std::system_error);
+   }
+
+   SECTION("Modified rows should invalidate the stream") {
+      REQUIRE_NOTHROW(statement::execute(con_, "UPDATE attachments SET data = x'00' WHERE id = 1;"));
+
+      ec.clear();
+      blob.read(data, 4, ec);
+      REQUIRE(ec == errors::condition::abort);
+   }
+}
@@ -0,0 +1,172 @@
+/**
+ * @file   bulk_inserter.cpp
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sqlite-burrito/bulk_inserter.h>
+#include <sqlite-burrito/connection.h>
+#include <sqlite-burrito/statement.h>
+
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <thread>
+
+using namespace sqlite_burrito;
+
+namespace {
+
+class bulk_inserter_test {
+public:
+   bulk_inserter_test() {
+      con_.open(":memory:");
+      statement::execute(con_, "CREATE TABLE test(id INTEGER NOT NULL, name TEXT);");
+      insert_.prepare("INSERT INTO test(id, name) VALUES (?, ?);");
+      count_.prepare("SELECT COUNT(*) FROM test;");
+   }
+
+public:
+   int count_entries() {
+      int result;
+      count_.reset();
+      count_.step();
+      count_.get(0, result);
+      return result;
+   }
+
+protected:
+   connection con_{};
+   statement insert_{con_};
+   statement count_{con_};
+};
+
+} // namespace
+
+TEST_CASE_METHOD(bulk_inserter_test, "Rows should be committed in batches", "[bulk_inserter]") {
+   bulk_inserter inserter{con_, insert_, {10, std::chrono::milliseconds{0}}};
+
+   for (int i = 0; i < 25; ++i) {
+      REQUIRE_NOTHROW(inserter.insert(i, std::string{"name"}));
+   }
+
+   REQUIRE(inserter.pending() == 5);
+   REQUIRE(inserter.stats().commits == 2);
+   REQUIRE(inserter.stats().rows == 20);
+
+   REQUIRE_NOTHROW(inserter.flush());
+   REQUIRE(inserter.pending() == 0);
+   REQUIRE(inserter.stats().commits == 3);
+   REQUIRE(inserter.stats().rows == 25);
+   REQUIRE(inserter.stats().average_commit_time() <= inserter.stats().max_commit_time);
+   REQUIRE(count_entries() == 25);
+}
+
+TEST_CASE_METHOD(bulk_inserter_test, "Rows should be committed after the batch time", "[bulk_inserter]") {
+   bulk_inserter inserter{con_, insert_, {0, std::chrono::milliseconds{1}}};
+
+   REQUIRE_NOTHROW(inserter.insert_tuple(std::make_tuple(1, std::string{"first"})));
+   std::this_thread::sleep_for(std::chrono::milliseconds{5});
+   REQUIRE_NOTHROW(inserter.insert_tuple(std::make_tuple(2, std::string{"second"})));
+
+   REQUIRE(inserter.pending() == 0);
+   REQUIRE(inserter.stats().rows == 2);
+   REQUIRE(inserter.stats().rows_per_second() > 0.0);
+}
+
+TEST_CASE_METHOD(bulk_inserter_test, "Idle batches should be committed when due", "[bulk_inserter]") {
+   bulk_inserter inserter{con_, insert_, {0, std::chrono::milliseconds{5}}};
+
+   REQUIRE_NOTHROW(inserter.insert(1, std::string{"first"}));
+   REQUIRE_NOTHROW(inserter.flush_if_due());
+   REQUIRE(inserter.pending() == 1);
+
+   std::this_thread::sleep_for(std::chrono::milliseconds{10});
+   REQUIRE_NOTHROW(inserter.flush_if_due());
+   REQUIRE(inserter.pending() == 0);
+   REQUIRE(inserter.stats().commits == 1);
+
+   // Nothing to commit
+   REQUIRE_NOTHROW(inserter.flush_if_due());
+   REQUIRE(inserter.stats().commits == 1);
+}
+
+TEST_CASE_METHOD(bulk_inserter_test, "Pending rows should be committed on destruction", "[bulk_inserter]") {
+   {
+      bulk_inserter inserter{con_, insert_};
+      for (int i = 0; i < 5; ++i) {
+         REQUIRE_NOTHROW(inserter.insert_with([i](statement &stmt, std::error_code &ec) {
+            stmt.bind(1, i, ec);
+            if (!ec) {
+               stmt.bind_null(2, ec);
+            }
+         }));
+      }
+   }
+
+   REQUIRE(count_entries() == 5);
+}
+
+TEST_CASE_METHOD(bulk_inserter_test, "Failed rows should be reported and discarding should roll back", "[bulk_inserter]") {
+   bulk_inserter inserter{con_, insert_};
+
+   REQUIRE_NOTHROW(inserter.insert(1, std::string{"valid"}));
+
+   std::error_code ec;
+   inserter.insert_with([](statement &stmt, std::error_code &bind_ec) { stmt.bind_null(1, bind_ec); }, ec);
+   REQUIRE(ec == errors::condition::constraint);
+   REQUIRE(inserter.pending() == 1);
+
+   // The statement should still be usable after a failure
+   REQUIRE_NOTHROW(inserter.insert(2, std::string{"valid"}));
+   REQUIRE(inserter.pending() == 2);
+
+   inserter.discard();
+   REQUIRE(inserter.pending() == 0);
+   REQUIRE(count_entries() == 0);
+}
+
+TEST_CASE("Failed commits should keep the batch for a retry", "[bulk_inserter]") {
+   const auto path = (std::filesystem::temp_directory_path() / "sqlite-burrito-bulk-test.db").string();
+   std::filesystem::remove(path);
+
+   connection con;
+   REQUIRE_NOTHROW(con.open(path));
+   REQUIRE_NOTHROW(statement::execute(con, "CREATE TABLE test(value INTEGER);"));
+
+   statement insert{con};
+   REQUIRE_NOTHROW(insert.prepare("INSERT INTO test(value) VALUES (?);"));
+
+   connection reader;
+   REQUIRE_NOTHROW(reader.open(path));
+
+   statement select{reader};
+   REQUIRE_NOTHROW(select.prepare("SELECT COUNT(*) FROM test;"));
+
+   {
+      bulk_inserter inserter{con, insert, {0, std::chrono::milliseconds{0}}};
+      REQUIRE_NOTHROW(inserter.insert(1));
+      REQUIRE_NOTHROW(inserter.insert(2));
+
+      // A pending read keeps the shared lock, which prevents the commit in the rollback journal mode
+      REQUIRE(select.step());
+
+      std::error_code ec;
+      inserter.flush(ec);
+      REQUIRE(ec == errors::condition::busy);
+      REQUIRE(inserter.pending() == 2);
+
+      REQUIRE_NOTHROW(select.reset());
+      REQUIRE_NOTHROW(inserter.flush());
+      REQUIRE(inserter.pending() == 0);
+      REQUIRE(inserter.stats().rows == 2);
+   }
+
+   int count = 0;
+   REQUIRE(select.step());
+   REQUIRE_NOTHROW(select.get(0, count));
+   REQUIRE(count == 2);
+
+   REQUIRE_NOTHROW(select.reset());
+   std::filesystem::remove(path);
+}
@@ -8,6 +8,16 @@
 
 #include <sqlite-burrito/connection.h>
 #include <sqlite-burrito/errors/sqlite.h>
+#include <sqlite-burrito/statement.h>
+#include <sqlite-burrito/statement_cache.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace sqlite_burrito;
 
@@ -40,4 +50,462 @@ TEST_CASE("Opening non-existent file should fail", "[connection][open_flags]") {
    std::error_code ec;
    REQUIRE_NOTHROW(conn.open(invalid_file_name, ec));
    REQUIRE(ec == errors::condition::cantopen);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Closing should not wait for outstanding statements", "[connection][close]") {
+   auto conn = std::make_unique<connection>();
+   REQUIRE_NOTHROW(conn->open(":memory:"));
+
+   // Internal statements should not prevent closing
+   REQUIRE_NOTHROW(conn->begin_transaction().commit());
+   { auto cached = conn->cache().acquire("SELECT 2;"); }
+
+   auto stmt = std::make_unique<statement>(*conn);
+   REQUIRE_NOTHROW(stmt->prepare("SELECT 1;"));
+   REQUIRE(stmt->step());
+
+   auto outstanding = conn->outstanding_statements();
+   REQUIRE(std::find(outstanding.begin(), outstanding.end(), "SELECT 1;") != outstanding.end());
+
+   const auto start = std::chrono::steady_clock::now();
+
+   std::vector<std::string> still_open;
+   REQUIRE_NOTHROW(still_open = conn->close());
+   REQUIRE(still_open == std::vector<std::string>{"SELECT 1;"});
+   REQUIRE(conn->outstanding_statements().empty());
+
+   // Closing again is a no-op
+   REQUIRE(conn->close().empty());
+   conn.reset();
+
+   REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds{1});
+
+   // The zombie connection is released together with the last statement
+   REQUIRE_NOTHROW(stmt.reset());
+}
+
+TEST_CASE("Clean close should report nothing", "[connection][close]") {
+   connection conn;
+   REQUIRE_NOTHROW(conn.open(":memory:"));
+   {
+      statement stmt{conn};
+      REQUIRE_NOTHROW(stmt.prepare("SELECT 1;"));
+   }
+   REQUIRE(conn.close().empty());
+}
+
+TEST_CASE("Busy policy should retry locked operations", "[connection][busy]") {
+   const auto path = (std::filesystem::temp_directory_path() / "sqlite-burrito-busy-test.db").string();
+   std::filesystem::remove(path);
+
+   connection holder;
+   REQUIRE_NOTHROW(holder.open(path));
+   REQUIRE_NOTHROW(statement::execute(holder, "CREATE TABLE test(value INTEGER);"));
+
+   connection waiter;
+   REQUIRE_NOTHROW(waiter.open(path));
+
+   connection::busy_policy policy;
+   policy.timeout = std::chrono::milliseconds{50};
+   policy.initial_delay = std::chrono::microseconds{500};
+   policy.max_delay = std::chrono::milliseconds{5};
+   REQUIRE_NOTHROW(waiter.set_busy_policy(policy));
+
+   SECTION("Invalid policies should be rejected") {
+      auto invalid = policy;
+      invalid.jitter = 2.0;
+      REQUIRE_THROWS_AS(waiter.set_busy_policy(invalid), std::system_error);
+   }
+
+   SECTION("Giving up after the timeout") {
+      auto lock = holder.begin_transaction(transaction::behavior::exclusive);
+
+      const auto start = std::chrono::steady_clock::now();
+      std::error_code ec;
+      statement::execute(waiter, "INSERT INTO test(value) VALUES (1);", ec);
+      REQUIRE(ec == errors::condition::busy);
+      REQUIRE(std::chrono::steady_clock::now() - start >= policy.timeout);
+
+      auto stats = waiter.busy_stats();
+      REQUIRE(stats.events == 1);
+      REQUIRE(stats.retries > 1);
+      REQUIRE(stats.failures == 1);
+      REQUIRE(stats.wait_time > std::chrono::milliseconds{25});
+   }
+
+   SECTION("Giving up after the maximal number of retries") {
+      auto lock = holder.begin_transaction(transaction::behavior::exclusive);
+
+      policy.timeout = std::chrono::seconds{10};
+      policy.max_retries = 3;
+      REQUIRE_NOTHROW(waiter.set_busy_policy(policy));
+
+      std::error_code ec;
+      statement::execute(waiter, "INSERT INTO test(value) VALUES (1);", ec);
+      REQUIRE(ec == errors::condition::busy);
+      REQUIRE(waiter.busy_stats().retries == 3);
+   }
+
+   SECTION("Succeeding once the lock is released") {
+      policy.timeout = std::chrono::seconds{10};
+      REQUIRE_NOTHROW(waiter.set_busy_policy(policy));
+
+      auto lock = std::make_unique<transaction>(holder, transaction::behavior::exclusive);
+      std::thread releaser{[&] {
+         std::this_thread::sleep_for(std::chrono::milliseconds{20});
+         lock->commit();
+      }};
+
+      std::error_code ec;
+      statement::execute(waiter, "INSERT INTO test(value) VALUES (1);", ec);
+      releaser.join();
+
+      REQUIRE(!ec);
+      auto stats = waiter.busy_stats();
+      REQUIRE(stats.events == 1);
+      REQUIRE(stats.failures == 0);
+      REQUIRE(stats.wait_time > std::chrono::milliseconds{10});
+   }
+
+   SECTION("Statements outliving the connection should not use its busy policy") {
+      statement stmt{waiter};
+      REQUIRE_NOTHROW(stmt.prepare("INSERT INTO test(value) VALUES (1);"));
+
+      SECTION("Closed") {
+         REQUIRE(waiter.close() == std::vector<std::string>{"INSERT INTO test(value) VALUES (1);"});
+      }
+
+      SECTION("Re-opened") {
+         REQUIRE_NOTHROW(waiter.open(":memory:"));
+      }
+
+      const auto events = waiter.busy_stats().events;
+      auto lock = holder.begin_transaction(transaction::behavior::exclusive);
+
+      std::error_code ec;
+      stmt.execute(ec);
+      REQUIRE(ec == errors::condition::busy);
+      REQUIRE(waiter.busy_stats().events == events);
+   }
+
+   SECTION("Cleared policy should fail immediately") {
+      auto lock = holder.begin_transaction(transaction::behavior::exclusive);
+      waiter.clear_busy_policy();
+
+      std::error_code ec;
+      statement::execute(waiter, "INSERT INTO test(value) VALUES (1);", ec);
+      REQUIRE(ec == errors::condition::busy);
+      REQUIRE(waiter.busy_stats().events == 0);
+   }
+}
+
+TEST_CASE("Zombie connections should not reference the busy policy", "[connection][busy]") {
+   const auto path = (std::filesystem::temp_directory_path() / "sqlite-burrito-zombie-test.db").string();
+   std::filesystem::remove(path);
+
+   connection holder;
+   REQUIRE_NOTHROW(holder.open(path));
+   REQUIRE_NOTHROW(statement::execute(holder, "CREATE TABLE test(value INTEGER);"));
+
+   auto waiter = std::make_unique<connection>();
+   REQUIRE_NOTHROW(waiter->open(path));
+   REQUIRE_NOTHROW(waiter->set_busy_policy(connection::busy_policy{}));
+
+   statement stmt{*waiter};
+   REQUIRE_NOTHROW(stmt.prepare("INSERT INTO test(value) VALUES (1);"));
+
+   // The busy state is gone together with the connection object, but the statement is still usable
+   REQUIRE(waiter->close().size() == 1);
+   waiter.reset();
+
+   auto lock = holder.begin_transaction(transaction::behavior::exclusive);
+
+   std::error_code ec;
+   stmt.execute(ec);
+   REQUIRE(ec == errors::condition::busy);
+}
+
+namespace {
+
+std::string pragma_value(connection &conn, const std::string &name) {
+   statement stmt{conn};
+   stmt.prepare("PRAGMA " + name + ";");
+   stmt.step();
+
+   std::string result;
+   stmt.get(0, result);
+   return result;
+}
+
+} // namespace
+
+TEST_CASE("Connection options should be applied on open", "[connection][options]") {
+   const auto path = (std::filesystem::temp_directory_path() / "sqlite-burrito-options-test.db").string();
+   for (auto suffix : {"", "-wal", "-shm"}) {
+      std::filesystem::remove(path + suffix);
+   }
+
+   connection conn;
+
+   SECTION("Throughput profile") {
+      REQUIRE_NOTHROW(conn.open(path, connection_options::throughput()));
+      REQUIRE(pragma_value(conn, "journal_mode") == "wal");
+      REQUIRE(pragma_value(conn, "synchronous") == "1");
+      REQUIRE(pragma_value(conn, "cache_size") == "-65536");
+      REQUIRE(pragma_value(conn, "temp_store") == "2");
+      REQUIRE(pragma_value(conn, "foreign_keys") == "1");
+   }
+
+   SECTION("Durable profile") {
+      REQUIRE_NOTHROW(conn.open(path, connection_options::durable()));
+      REQUIRE(pragma_value(conn, "journal_mode") == "wal");
+      REQUIRE(pragma_value(conn, "synchronous") == "2");
+   }
+
+   SECTION("Bulk-load profile") {
+      REQUIRE_NOTHROW(conn.open(path, connection_options::bulk_load()));
+      REQUIRE(pragma_value(conn, "journal_mode") == "memory");
+      REQUIRE(pragma_value(conn, "synchronous") == "0");
+      REQUIRE(pragma_value(conn, "locking_mode") == "exclusive");
+      REQUIRE(pragma_value(conn, "wal_autocheckpoint") == "0");
+   }
+
+   SECTION("Individual settings") {
+      connection_options options;
+      options.page_size = 8192;
+      options.journal = connection_options::journal_mode::truncate;
+      options.wal_autocheckpoint = 500;
+      REQUIRE_NOTHROW(conn.open(path, options));
+      REQUIRE(pragma_value(conn, "page_size") == "8192");
+      REQUIRE(pragma_value(conn, "journal_mode") == "truncate");
+      REQUIRE(pragma_value(conn, "wal_autocheckpoint") == "500");
+   }
+
+   SECTION("Failed options should keep the current connection") {
+      REQUIRE_NOTHROW(conn.open(path));
+      REQUIRE_NOTHROW(statement::execute(conn, "CREATE TABLE test(value INTEGER);"));
+
+      connection_options options;
+      options.journal = static_cast<connection_options::journal_mode>(42);
+
+      std::error_code ec;
+      conn.open(":memory:", options, ec);
+      REQUIRE(ec == std::errc::invalid_argument);
+      REQUIRE_NOTHROW(statement::execute(conn, "INSERT INTO test(value) VALUES (1);"));
+
+      // In-memory databases can't be switched into the WAL mode
+      ec.clear();
+      conn.open(":memory:", connection_options::durable(), ec);
+      REQUIRE(ec == std::errc::not_supported);
+      REQUIRE_NOTHROW(statement::execute(conn, "INSERT INTO test(value) VALUES (2);"));
+   }
+
+   conn.close();
+   for (auto suffix : {"", "-wal", "-shm"}) {
+      std::filesystem::remove(path + suffix);
+   }
+}
+
+TEST_CASE("Memory-mapped I/O should bypass the page cache", "[connection][mmap]") {
+   const auto path = (std::filesystem::temp_directory_path() / "sqlite-burrito-mmap-test.db").string();
+   std::filesystem::remove(path);
+
+   {
+      connection conn;
+      REQUIRE_NOTHROW(conn.open(path));
+      REQUIRE_NOTHROW(statement::execute(conn, "CREATE TABLE test(value TEXT);"
+                                               "WITH RECURSIVE r(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM r "
+                                               "WHERE x < 2000) INSERT INTO test SELECT printf('%0200d', x) FROM r;"));
+      REQUIRE(conn.io_stats().cache_writes > 0);
+   }
+
+   const auto scan = [&](std::int64_t mmap_size) {
+      connection conn;
+      conn.open(path);
+      const auto effective = conn.set_mmap_size(mmap_size);
+      REQUIRE(effective == conn.mmap_size());
+
+      statement::execute(conn, "SELECT COUNT(value) FROM test;");
+      auto first = conn.io_stats(true);
+      REQUIRE(first.mmap_size == effective);
+
+      statement::execute(conn, "SELECT COUNT(value) FROM test;");
+      return std::make_pair(first, conn.io_stats());
+   };
+
+   auto [plain_first, plain_second] = scan(0);
+   REQUIRE(plain_first.mmap_size == 0);
+   REQUIRE(plain_first.cache_misses > 0);
+
+   // The counters were reset after the first scan, which warmed up the cache
+   REQUIRE(plain_second.cache_misses == 0);
+   REQUIRE(plain_second.cache_hits > 0);
+   REQUIRE(plain_second.hit_ratio() == 1.0);
+
+   auto [mapped_first, mapped_second] = scan(16 * 1024 * 1024);
+   if (mapped_first.mmap_size > 0) {
+      // Memory-mapped I/O might be disabled at compile time
+      REQUIRE(mapped_first.cache_misses < plain_first.cache_misses);
+   }
+
+   std::error_code ec;
+   connection conn;
+   REQUIRE_NOTHROW(conn.open(":memory:"));
+   conn.set_mmap_size(-1, ec);
+   REQUIRE(ec == std::errc::invalid_argument);
+
+   std::filesystem::remove(path);
+}
+
+TEST_CASE("Memory statistics should be reported", "[connection][stats]") {
+   connection conn;
+   REQUIRE_NOTHROW(conn.open(":memory:"));
+
+   const auto before = conn.stats();
+
+   REQUIRE_NOTHROW(statement::execute(conn, "CREATE TABLE test(id INTEGER PRIMARY KEY, value TEXT);"
+                                            "CREATE INDEX test_value ON test(value);"
+                                            "INSERT INTO test(value) VALUES ('a'), ('b'), ('c');"));
+
+   statement stmt{conn};
+   REQUIRE_NOTHROW(stmt.prepare("SELECT value FROM test WHERE value > 'a';"));
+
+   auto after = conn.stats();
+   REQUIRE(after.schema_used > before.schema_used);
+   REQUIRE(after.statement_used > before.statement_used);
+   REQUIRE(after.cache_used > 0);
+   REQUIRE(after.cache_used_shared > 0);
+   REQUIRE(after.lookaside_used.highwater >= after.lookaside_used.current);
+
+   SECTION("Closed connections") {
+      REQUIRE_NOTHROW(conn.close());
+
+      std::error_code ec;
+      auto closed = conn.stats(false, ec);
+      REQUIRE(ec == errors::condition::misuse);
+      REQUIRE(closed.cache_used == 0);
+
+      ec.clear();
+      auto io = conn.io_stats(false, ec);
+      REQUIRE(ec == errors::condition::misuse);
+      REQUIRE(io.mmap_size == 0);
+
+      REQUIRE_THROWS(conn.stats());
+      REQUIRE_THROWS(conn.io_stats());
+   }
+
+   SECTION("Global statistics") {
+      auto global = global_stats();
+      REQUIRE(global.memory_used.current > 0);
+      REQUIRE(global.memory_used.highwater >= global.memory_used.current);
+      REQUIRE(global.malloc_count.current > 0);
+      REQUIRE(global.malloc_size.highwater > 0);
+
+      // Resetting the high-water marks brings them down to the current values
+      {
+         connection other;
+         REQUIRE_NOTHROW(other.open(":memory:"));
+         REQUIRE_NOTHROW(statement::execute(other, "CREATE TABLE big(value BLOB); INSERT INTO big VALUES "
+                                                   "(zeroblob(1000000));"));
+      }
+
+      auto peak = global_stats(true);
+      auto reset = global_stats();
+      REQUIRE(reset.memory_used.highwater <= peak.memory_used.highwater);
+      REQUIRE(reset.memory_used.highwater < peak.memory_used.highwater - 500000);
+   }
+}
+
+TEST_CASE("Databases should survive a serialization round trip", "[connection][serialize]") {
+   const auto count_rows = [](connection &conn) {
+      statement stmt{conn};
+      stmt.prepare("SELECT COUNT(*) FROM test;");
+      stmt.step();
+
+      int result = -1;
+      stmt.get(0, result);
+      return result;
+   };
+
+   connection source;
+   REQUIRE_NOTHROW(source.open(":memory:"));
+   REQUIRE(source.serialize().empty());
+
+   REQUIRE_NOTHROW(statement::execute(source, "CREATE TABLE test(value TEXT);"
+                                              "WITH RECURSIVE r(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM r "
+                                              "WHERE x < 100) INSERT INTO test SELECT printf('%0100d', x) FROM r;"));
+
+   auto image = source.serialize();
+   REQUIRE(image.size() > 100 * 100);
+
+   // Same bytes as in a database file
+   REQUIRE(std::string(reinterpret_cast<const char *>(image.data()), 15) == "SQLite format 3");
+
+   connection target;
+   REQUIRE_NOTHROW(target.open(":memory:"));
+
+   SECTION("Resizeable") {
+      REQUIRE_NOTHROW(target.deserialize(std::move(image)));
+      REQUIRE(image.empty());
+      REQUIRE(count_rows(target) == 100);
+
+      REQUIRE_NOTHROW(statement::execute(target, "INSERT INTO test SELECT value FROM test;"));
+      REQUIRE(count_rows(target) == 200);
+
+      // The source is not affected
+      REQUIRE(count_rows(source) == 100);
+   }
+
+   SECTION("Copied") {
+      auto copy = database_image::copy_of(image.data(), image.size());
+      image = database_image{};
+
+      REQUIRE_NOTHROW(target.deserialize(std::move(copy), connection::deserialize_flags::none));
+      REQUIRE(count_rows(target) == 100);
+
+      // Without the resizeable flag, the database cannot grow
+      std::error_code ec;
+      statement::execute(target, "INSERT INTO test SELECT value FROM test;", ec);
+      REQUIRE(ec == errors::condition::full);
+   }
+
+   SECTION("Closed connections") {
+      REQUIRE_NOTHROW(target.close());
+
+      std::error_code ec;
+      auto closed = target.serialize(ec);
+      REQUIRE(ec == errors::condition::misuse);
+      REQUIRE(closed.empty());
+
+      // The image is taken over (and released) even on failures
+      ec.clear();
+      target.deserialize(std::move(image), connection::deserialize_flags::resizeable, ec);
+      REQUIRE(ec == errors::condition::misuse);
+      REQUIRE(image.empty());
+   }
+
+   SECTION("Read-only") {
+      REQUIRE_NOTHROW(target.deserialize(std::move(image), connection::deserialize_flags::readonly |
+                                                               connection::deserialize_flags::resizeable));
+      REQUIRE(count_rows(target) == 100);
+
+      std::error_code ec;
+      statement::execute(target, "DELETE FROM test;", ec);
+      REQUIRE(ec == errors::condition::readonly);
+   }
+
+   SECTION("File") {
+      const auto path = (std::filesystem::temp_directory_path() / "sqlite-burrito-serialize-test.db").string();
+      std::filesystem::remove(path);
+      REQUIRE_NOTHROW(statement::execute(source, "VACUUM INTO '" + path + "';"));
+
+      // Serializing a file database reads it in one go
+      connection file;
+      REQUIRE_NOTHROW(file.open(path));
+      REQUIRE_NOTHROW(target.deserialize(file.serialize()));
+      REQUIRE(count_rows(target) == 100);
+
+      file.close();
+      std::filesystem::remove(path);
+   }
+}
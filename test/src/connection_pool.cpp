@@ -0,0 +1,210 @@
+/**
+ * @file   connection_pool.cpp
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sqlite-burrito/connection_pool.h>
+#include <sqlite-burrito/statement.h>
+
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+using namespace sqlite_burrito;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+class connection_pool_test {
+public:
+   connection_pool_test() {
+      remove_files();
+
+      connection_pool::options opts;
+      opts.readers = 3;
+      opts.settings.synchronous = connection_options::synchronous_mode::normal;
+      opts.pragmas = {"PRAGMA cache_size = -4096;"};
+
+      pool_ = std::make_unique<connection_pool>(opts);
+      pool_->open(path_.string());
+      pool_->write([](connection &con, std::error_code &ec) {
+         statement::execute(con, "CREATE TABLE test(id INTEGER PRIMARY KEY, value INTEGER);", ec);
+      });
+   }
+
+   ~connection_pool_test() {
+      pool_.reset();
+      remove_files();
+   }
+
+private:
+   void remove_files() {
+      for (auto suffix : {"", "-wal", "-shm"}) {
+         std::error_code ec;
+         fs::remove(path_.string() + suffix, ec);
+      }
+   }
+
+protected:
+   fs::path path_{fs::temp_directory_path() / "sqlite-burrito-pool-test.db"};
+   std::unique_ptr<connection_pool> pool_{};
+};
+
+int count_rows(connection &con) {
+   statement stmt{con};
+   stmt.prepare("SELECT COUNT(*) FROM test;");
+   stmt.step();
+
+   int result;
+   stmt.get(0, result);
+   return result;
+}
+
+} // namespace
+
+TEST_CASE_METHOD(connection_pool_test, "Readers should be read-only", "[connection_pool]") {
+   auto reader = pool_->reader();
+   REQUIRE(reader);
+   REQUIRE(!reader.is_writer());
+   REQUIRE(::sqlite3_db_readonly(&reader->native_handle(), "main") == 1);
+
+   std::error_code ec;
+   statement::execute(*reader, "INSERT INTO test(value) VALUES (1);", ec);
+   REQUIRE(ec);
+
+   auto writer = pool_->writer();
+   REQUIRE(writer.is_writer());
+   REQUIRE(::sqlite3_db_readonly(&writer->native_handle(), "main") == 0);
+
+   statement journal{*writer};
+   journal.prepare("PRAGMA journal_mode;");
+   REQUIRE(journal.step());
+
+   std::string mode;
+   journal.get(0, mode);
+   REQUIRE(mode == "wal");
+
+   // Settings and additional pragmas should be applied to the readers as well
+   const auto pragma_value = [](connection &con, const char *sql) {
+      statement stmt{con};
+      stmt.prepare(sql);
+      stmt.step();
+
+      int result = 0;
+      stmt.get(0, result);
+      return result;
+   };
+
+   for (auto con : {&*reader, &*writer}) {
+      REQUIRE(pragma_value(*con, "PRAGMA synchronous;") == 1);
+      REQUIRE(pragma_value(*con, "PRAGMA cache_size;") == -4096);
+   }
+}
+
+TEST_CASE_METHOD(connection_pool_test, "Writes should be transactional", "[connection_pool]") {
+   REQUIRE_NOTHROW(pool_->write([](connection &con, std::error_code &ec) {
+      statement::execute(con, "INSERT INTO test(value) VALUES (1);", ec);
+   }));
+
+   std::error_code ec;
+   pool_->write(
+       [](connection &con, std::error_code &ec) {
+          statement::execute(con, "INSERT INTO test(value) VALUES (2);", ec);
+          ec = std::make_error_code(std::errc::operation_canceled);
+       },
+       ec);
+   REQUIRE(ec == std::errc::operation_canceled);
+
+   auto reader = pool_->reader();
+   REQUIRE(count_rows(*reader) == 1);
+}
+
+TEST_CASE_METHOD(connection_pool_test, "Acquisitions should time out", "[connection_pool]") {
+   std::vector<connection_pool::lease> readers;
+   for (int i = 0; i < 3; ++i) {
+      readers.push_back(pool_->reader());
+   }
+
+   std::error_code ec;
+   auto reader = pool_->reader(std::chrono::milliseconds{10}, ec);
+   REQUIRE(ec == std::errc::timed_out);
+   REQUIRE(!reader);
+
+   auto writer = pool_->writer();
+   auto other_writer = pool_->writer(std::chrono::milliseconds{10}, ec);
+   REQUIRE(ec == std::errc::timed_out);
+   REQUIRE(!other_writer);
+
+   auto stats = pool_->stats();
+   REQUIRE(stats.timeouts == 2);
+   REQUIRE(stats.readers == 3);
+   REQUIRE(stats.readers_in_use == 3);
+   REQUIRE(stats.writers_in_use == 1);
+
+   readers.pop_back();
+   ec.clear();
+   reader = pool_->reader(std::chrono::milliseconds{10}, ec);
+   REQUIRE(!ec);
+   REQUIRE(reader);
+}
+
+TEST_CASE_METHOD(connection_pool_test, "Pool should survive concurrent use", "[connection_pool]") {
+   const int num_threads = 16;
+   const int iterations = 50;
+   const int write_every = 5;
+
+   std::atomic<int> failures{0};
+   std::vector<std::thread> threads;
+   for (int t = 0; t < num_threads; ++t) {
+      threads.emplace_back([&, t] {
+         try {
+            for (int i = 0; i < iterations; ++i) {
+               if (i % write_every == 0) {
+                  pool_->write([&](connection &con, std::error_code &ec) {
+                     statement insert{con};
+                     insert.prepare("INSERT INTO test(value) VALUES (:pvalue);", ec);
+                     if (!ec) {
+                        insert.bind(":pvalue", t * iterations + i, ec);
+                     }
+                     if (!ec) {
+                        insert.execute(ec);
+                     }
+                  });
+               } else {
+                  auto reader = pool_->reader();
+                  if (count_rows(*reader) < 0) {
+                     ++failures;
+                  }
+               }
+            }
+         } catch (const std::exception &) {
+            ++failures;
+         }
+      });
+   }
+
+   for (auto &thread : threads) {
+      thread.join();
+   }
+
+   REQUIRE(failures == 0);
+
+   auto reader = pool_->reader();
+   REQUIRE(count_rows(*reader) == num_threads * iterations / write_every);
+   reader.release();
+
+   auto stats = pool_->stats();
+   REQUIRE(stats.readers_in_use == 0);
+   REQUIRE(stats.writers_in_use == 0);
+   REQUIRE(stats.writer_acquisitions == 1 + num_threads * iterations / write_every);
+   REQUIRE(stats.reader_acquisitions == 1 + num_threads * iterations * (write_every - 1) / write_every);
+   REQUIRE(stats.reader_utilization() >= 0.0);
+   REQUIRE(stats.reader_utilization() <= 1.0);
+   REQUIRE(stats.writer_utilization() > 0.0);
+   REQUIRE(stats.writer_utilization() <= 1.0);
+}
@@ -0,0 +1,165 @@
+/**
+ * @file   coroutines.cpp
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sqlite-burrito/coroutines.h>
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+using namespace sqlite_burrito;
+
+namespace {
+
+//! Minimal eagerly started coroutine, reporting its completion via a future
+struct test_task {
+   struct promise_type {
+      std::promise<void> done{};
+
+      test_task get_return_object() { return test_task{done.get_future()}; }
+
+      std::suspend_never initial_suspend() noexcept { return {}; }
+      std::suspend_never final_suspend() noexcept { return {}; }
+
+      void return_void() { done.set_value(); }
+      void unhandled_exception() { done.set_exception(std::current_exception()); }
+   };
+
+   std::future<void> done;
+};
+
+//! Single-threaded event loop, resuming the coroutines on the thread calling `run`
+class event_loop {
+public:
+   void post(std::coroutine_handle<> handle) {
+      // Notifying under the lock, so that the loop can be destroyed once the last coroutine is done
+      std::lock_guard lock{mutex_};
+      handles_.push_back(handle);
+      cv_.notify_one();
+   }
+
+   void run(std::future<void> &done) {
+      while (done.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+         std::unique_lock lock{mutex_};
+         if (!cv_.wait_for(lock, std::chrono::milliseconds{10}, [this] { return !handles_.empty(); })) {
+            continue;
+         }
+
+         auto handle = handles_.front();
+         handles_.pop_front();
+         lock.unlock();
+
+         handle.resume();
+      }
+   }
+
+private:
+   std::mutex mutex_{};
+   std::condition_variable cv_{};
+   std::deque<std::coroutine_handle<>> handles_{};
+};
+
+struct query_result {
+   std::vector<std::size_t> batch_sizes{};
+   std::vector<std::tuple<int, std::string>> rows{};
+   std::vector<std::thread::id> threads{};
+};
+
+test_task fill_and_query(coroutine_connection db, query_result &result) {
+   co_await db.execute("CREATE TABLE test(id INTEGER PRIMARY KEY, name TEXT);");
+   result.threads.push_back(std::this_thread::get_id());
+
+   auto insert = co_await db.prepare("INSERT INTO test(name) VALUES (?);");
+   for (int i = 0; i < 10; ++i) {
+      co_await db.submit([&](connection &) {
+         insert->reset();
+         insert->bind(1, "row " + std::to_string(i));
+      });
+
+      if (co_await db.execute(*insert) != 1) {
+         throw std::runtime_error("Insert failed");
+      }
+   }
+   result.threads.push_back(std::this_thread::get_id());
+
+   auto select = co_await db.prepare("SELECT id, name FROM test ORDER BY id;");
+   auto rows = db.rows<int, std::string>(*select, 4);
+   for (auto batch = co_await rows.next(); !batch.empty(); batch = co_await rows.next()) {
+      result.batch_sizes.push_back(batch.size());
+      result.rows.insert(result.rows.end(), batch.begin(), batch.end());
+   }
+   result.threads.push_back(std::this_thread::get_id());
+
+   // Statements should be finalized on the worker
+   co_await db.submit([&](connection &) {
+      insert.reset();
+      select.reset();
+   });
+}
+
+test_task failing_query(coroutine_connection db, std::error_code &ec) {
+   try {
+      co_await db.execute("SELECT * FROM missing;");
+   } catch (const std::system_error &e) {
+      ec = e.code();
+   }
+}
+
+} // namespace
+
+TEST_CASE("Coroutines should await the worker jobs", "[coroutines]") {
+   async_connection worker;
+   REQUIRE_NOTHROW(worker.open(":memory:").get());
+
+   query_result result;
+
+   SECTION("Resumed on the worker") {
+      auto task = fill_and_query(coroutine_connection{worker}, result);
+      REQUIRE_NOTHROW(task.done.get());
+
+      for (auto id : result.threads) {
+         REQUIRE(id != std::this_thread::get_id());
+      }
+   }
+
+   SECTION("Resumed on an event loop") {
+      event_loop loop;
+      auto task = fill_and_query(coroutine_connection{worker, [&](auto handle) { loop.post(handle); }}, result);
+      loop.run(task.done);
+      REQUIRE_NOTHROW(task.done.get());
+
+      for (auto id : result.threads) {
+         REQUIRE(id == std::this_thread::get_id());
+      }
+   }
+
+   REQUIRE(result.batch_sizes == std::vector<std::size_t>{4, 4, 2});
+   REQUIRE(result.rows.size() == 10);
+   REQUIRE(result.rows.front() == std::make_tuple(1, std::string{"row 0"}));
+   REQUIRE(result.rows.back() == std::make_tuple(10, std::string{"row 9"}));
+}
+
+TEST_CASE("Coroutine errors should be re-thrown by co_await", "[coroutines]") {
+   async_connection worker;
+   REQUIRE_NOTHROW(worker.open(":memory:").get());
+
+   std::error_code ec;
+   REQUIRE_NOTHROW(failing_query(coroutine_connection{worker}, ec).done.get());
+   REQUIRE(ec);
+
+   // Stopped workers don't accept jobs, and the coroutine is resumed right away
+   worker.stop();
+   ec.clear();
+   REQUIRE_NOTHROW(failing_query(coroutine_connection{worker}, ec).done.get());
+   REQUIRE(ec == std::errc::operation_canceled);
+}
@@ -0,0 +1,98 @@
+/**
+ * @file   sql_text.cpp
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sqlite-burrito/connection.h>
+#include <sqlite-burrito/sql_text.h>
+#include <sqlite-burrito/statement.h>
+
+#include <sqlite3.h>
+
+#include <string>
+#include <system_error>
+
+using namespace sqlite_burrito;
+
+namespace {
+
+constexpr sql_text insert_sql{"INSERT INTO test(first, second) VALUES (:pfirst, :psecond);"};
+constexpr auto pfirst = insert_sql.param(":pfirst");
+constexpr auto psecond = insert_sql.param(":psecond");
+
+static_assert(pfirst.index == 1);
+static_assert(psecond.index == 2);
+static_assert(insert_sql.parameter_count() == 2);
+static_assert(!insert_sql.has_param(":pthird"));
+
+constexpr sql_text mixed_sql{"SELECT ?, :a, ?5, @b, :a, ?, $c, ?2;"};
+static_assert(mixed_sql.parameter_count() == 8);
+static_assert(mixed_sql.param(":a").index == 2);
+static_assert(mixed_sql.param("?5").index == 5);
+static_assert(mixed_sql.param("@b").index == 6);
+static_assert(mixed_sql.param("$c").index == 8);
+
+constexpr sql_text quoted_sql{"SELECT ':a' AS \":b\", 1 AS [:c], 2 AS `:d` /* :e */, :f -- :g\n, :h; SELECT :i;"};
+static_assert(quoted_sql.parameter_count() == 2);
+static_assert(quoted_sql.param(":f").index == 1);
+static_assert(quoted_sql.param(":h").index == 2);
+static_assert(!quoted_sql.has_param(":a") && !quoted_sql.has_param(":e") && !quoted_sql.has_param(":i"));
+
+//! Compare the compile-time resolution against SQLite
+void check_against_sqlite(connection &con, sql_text sql) {
+   statement stmt{con};
+   REQUIRE_NOTHROW(stmt.prepare(sql));
+
+   auto handle = &stmt.native_handle();
+   const auto count = ::sqlite3_bind_parameter_count(handle);
+   REQUIRE(sql.parameter_count() == count);
+
+   for (int i = 1; i <= count; ++i) {
+      auto name = ::sqlite3_bind_parameter_name(handle, i);
+      if (name) {
+         REQUIRE(sql.param(name).index == i);
+      }
+   }
+}
+
+} // namespace
+
+TEST_CASE("Compile-time parameters should match SQLite", "[sql_text]") {
+   connection con;
+   REQUIRE_NOTHROW(con.open(":memory:"));
+   REQUIRE_NOTHROW(statement::execute(con, "CREATE TABLE test(first INTEGER, second TEXT);"));
+
+   check_against_sqlite(con, insert_sql);
+   check_against_sqlite(con, mixed_sql);
+   check_against_sqlite(con, quoted_sql);
+
+   SECTION("Unknown names should throw at runtime") {
+      std::error_code ec;
+      try {
+         (void)insert_sql.param(":pthird");
+      } catch (const std::system_error &e) {
+         ec = e.code();
+      }
+      REQUIRE(ec == std::errc::invalid_argument);
+   }
+
+   SECTION("Resolved handles should be bindable") {
+      statement insert{con};
+      REQUIRE_NOTHROW(insert.prepare(insert_sql));
+      REQUIRE_NOTHROW(insert.bind(pfirst, 42));
+      REQUIRE_NOTHROW(insert.bind(psecond, std::string{"value"}));
+      REQUIRE(insert.execute() == 1);
+
+      statement select{con};
+      REQUIRE_NOTHROW(select.prepare("SELECT first, second FROM test;"));
+      REQUIRE(select.step());
+
+      int first;
+      std::string second;
+      REQUIRE_NOTHROW(select.get(0, first));
+      REQUIRE_NOTHROW(select.get(1, second));
+      REQUIRE(first == 42);
+      REQUIRE(second == "value");
+   }
+}
@@ -9,8 +9,25 @@
 #include <sqlite-burrito/connection.h>
 #include <sqlite-burrito/statement.h>
 
+#include <algorithm>
+
 using namespace sqlite_burrito;
 
+namespace {
+
+struct mapped_entry {
+   int id{};
+   std::optional<std::string> name{};
+   double value{};
+};
+
+} // namespace
+
+template <>
+struct sqlite_burrito::row_traits<mapped_entry> {
+   static constexpr auto columns = std::make_tuple(&mapped_entry::id, &mapped_entry::name, &mapped_entry::value);
+};
+
 TEST_CASE("Prepare should return a valid iterator", "[statement][prepare]") {
    connection conn;
    REQUIRE_NOTHROW(conn.open(":memory:"));
@@ -383,3 +400,508 @@ CREATE TABLE IF NOT EXISTS test(
       REQUIRE_NOTHROW(stmt.execute());
    }
 }
+
+TEST_CASE("Name-based bindings should survive schema changes", "[statement][bind]") {
+   connection conn;
+   REQUIRE_NOTHROW(conn.open(":memory:"));
+   REQUIRE_NOTHROW(statement::execute(conn, "CREATE TABLE test(value TEXT);"));
+
+   statement stmt{conn};
+   REQUIRE_NOTHROW(stmt.prepare("INSERT INTO test(value) VALUES (:value);"));
+   REQUIRE_NOTHROW(stmt.bind(":value", "first"));
+   REQUIRE_NOTHROW(stmt.execute());
+
+   // The statement is re-prepared by SQLite on the next step, which releases the parameter names
+   REQUIRE_NOTHROW(statement::execute(conn, "CREATE TABLE other(value TEXT);"));
+   REQUIRE_NOTHROW(stmt.reset());
+   REQUIRE_NOTHROW(stmt.execute());
+
+   REQUIRE_NOTHROW(stmt.reset());
+   REQUIRE_NOTHROW(stmt.bind(":value", "second"));
+   REQUIRE_NOTHROW(stmt.execute());
+
+   statement count{conn};
+   REQUIRE_NOTHROW(count.prepare("SELECT COUNT(*) FROM test;"));
+   REQUIRE(count.step());
+
+   int result = 0;
+   REQUIRE_NOTHROW(count.get(0, result));
+   REQUIRE(result == 3);
+}
+
+TEST_CASE("Zero-copy bindings should store the bound values", "[statement][bind]") {
+   connection conn;
+   REQUIRE_NOTHROW(conn.open(":memory:"));
+   REQUIRE_NOTHROW(statement::execute(conn, "CREATE TABLE test(text_value TEXT, blob_value BLOB);"));
+
+   statement insert{conn};
+   REQUIRE_NOTHROW(insert.prepare("INSERT INTO test(text_value, blob_value) VALUES(:ptext, :pblob);"));
+
+   statement select{conn};
+   REQUIRE_NOTHROW(select.prepare("SELECT text_value, blob_value FROM test;"));
+
+   std::string text;
+   std::vector<std::uint8_t> blob;
+
+   SECTION("static index-based") {
+      const std::string source_text{"static text"};
+      const std::vector<std::uint8_t> source_blob{1, 2, 3};
+
+      REQUIRE_NOTHROW(insert.bind_static(1, source_text));
+      REQUIRE_NOTHROW(insert.bind_static(2, source_blob.data(), source_blob.size()));
+      REQUIRE_NOTHROW(insert.execute());
+
+      REQUIRE(select.step());
+      REQUIRE_NOTHROW(select.get(0, text));
+      REQUIRE_NOTHROW(select.get(1, blob));
+      REQUIRE(text == source_text);
+      REQUIRE(blob == source_blob);
+   }
+
+   SECTION("static name-based") {
+      const std::string source_text{"static text"};
+      const std::vector<std::uint8_t> source_blob{1, 2, 3};
+
+      REQUIRE_NOTHROW(insert.bind_static(":ptext", source_text));
+      REQUIRE_NOTHROW(insert.bind_static(":pblob", source_blob.data(), source_blob.size()));
+      REQUIRE_NOTHROW(insert.execute());
+
+      REQUIRE(select.step());
+      REQUIRE_NOTHROW(select.get(0, text));
+      REQUIRE_NOTHROW(select.get(1, blob));
+      REQUIRE(text == source_text);
+      REQUIRE(blob == source_blob);
+   }
+
+   SECTION("owned values should survive the source going out of scope") {
+      {
+         std::string source_text{"owned text, long enough to avoid the small string optimization"};
+         std::vector<std::uint8_t> source_blob{4, 5, 6};
+
+         REQUIRE_NOTHROW(insert.bind_owned(1, std::move(source_text)));
+         REQUIRE_NOTHROW(insert.bind_owned(":pblob", std::move(source_blob)));
+      }
+      REQUIRE_NOTHROW(insert.execute());
+
+      // Re-binding the same parameters should release the previous values
+      REQUIRE_NOTHROW(insert.reset());
+      REQUIRE_NOTHROW(insert.bind_owned(":ptext", std::string{"second"}));
+      REQUIRE_NOTHROW(insert.bind_owned(2, std::vector<std::uint8_t>{7}));
+      REQUIRE_NOTHROW(insert.execute());
+
+      REQUIRE(select.step());
+      REQUIRE_NOTHROW(select.get(0, text));
+      REQUIRE_NOTHROW(select.get(1, blob));
+      REQUIRE(text == "owned text, long enough to avoid the small string optimization");
+      REQUIRE(blob == std::vector<std::uint8_t>{4, 5, 6});
+
+      REQUIRE(select.step());
+      REQUIRE_NOTHROW(select.get(0, text));
+      REQUIRE_NOTHROW(select.get(1, blob));
+      REQUIRE(text == "second");
+      REQUIRE(blob == std::vector<std::uint8_t>{7});
+   }
+
+   SECTION("failed re-binds should keep the previous values") {
+      const std::string first{"owned text, long enough to avoid the small string optimization"};
+
+      statement echo{conn};
+      REQUIRE_NOTHROW(echo.prepare("SELECT ?;"));
+      REQUIRE_NOTHROW(echo.bind_owned(1, std::string{first}));
+      REQUIRE(echo.step());
+
+      // Statements cannot be re-bound before a reset
+      std::error_code ec;
+      echo.bind_owned(1, std::string{"second"}, ec);
+      REQUIRE(ec == errors::condition::misuse);
+
+      REQUIRE_NOTHROW(echo.reset());
+      REQUIRE(echo.step());
+      REQUIRE_NOTHROW(echo.get(0, text));
+      REQUIRE(text == first);
+
+      // Non-owning binds replace the owned values as well
+      REQUIRE_NOTHROW(echo.reset());
+      REQUIRE_NOTHROW(echo.bind(1, 5));
+      REQUIRE(echo.step());
+
+      int value = 0;
+      REQUIRE_NOTHROW(echo.get(0, value));
+      REQUIRE(value == 5);
+   }
+
+   SECTION("unknown names should be rejected") {
+      std::error_code ec;
+      insert.bind_static(":pmissing", std::string_view{"value"}, ec);
+      REQUIRE(ec == std::errc::invalid_argument);
+
+      insert.bind_owned(":pmissing", std::string{"value"}, ec);
+      REQUIRE(ec == std::errc::invalid_argument);
+   }
+}
+
+TEST_CASE("Column views should point into the current row", "[statement][get]") {
+   connection conn;
+   REQUIRE_NOTHROW(conn.open(":memory:"));
+   REQUIRE_NOTHROW(statement::execute(conn, R"sql(
+CREATE TABLE test(text_value TEXT, blob_value BLOB);
+INSERT INTO test(text_value, blob_value) VALUES ('first', X'010203'), ('second', X''), (NULL, NULL);
+)sql"));
+
+   statement stmt{conn};
+   REQUIRE_NOTHROW(stmt.prepare("SELECT text_value, blob_value FROM test ORDER BY rowid;"));
+
+   REQUIRE(stmt.step());
+   text_view text;
+   blob_view blob;
+   REQUIRE_NOTHROW(text = stmt.get_view(0));
+   REQUIRE_NOTHROW(blob = stmt.get_blob_view(1));
+   REQUIRE(text.valid());
+   REQUIRE(blob.valid());
+   REQUIRE(std::string_view{text} == "first");
+   REQUIRE(blob.size() == 3);
+   REQUIRE(blob[0] == std::byte{1});
+   REQUIRE(blob[2] == std::byte{3});
+
+   REQUIRE(stmt.step());
+   REQUIRE(!text.valid());
+   REQUIRE(!blob.valid());
+
+   REQUIRE_NOTHROW(text = stmt.get_view(0));
+   REQUIRE_NOTHROW(blob = stmt.get_blob_view(1));
+   REQUIRE(std::string_view{text} == "second");
+   REQUIRE(blob.empty());
+
+   REQUIRE(stmt.step());
+   REQUIRE_NOTHROW(text = stmt.get_view(0));
+   REQUIRE_NOTHROW(blob = stmt.get_blob_view(1));
+   REQUIRE(text.empty());
+   REQUIRE(blob.empty());
+
+   REQUIRE_NOTHROW(stmt.reset());
+   REQUIRE(stmt.step());
+   REQUIRE_NOTHROW(text = stmt.get_view(0));
+   REQUIRE(text.valid());
+   REQUIRE_NOTHROW(stmt.reset());
+   REQUIRE(!text.valid());
+}
+
+TEST_CASE("Column views should follow a moved statement", "[statement][get]") {
+   connection conn;
+   REQUIRE_NOTHROW(conn.open(":memory:"));
+
+   statement stmt{conn};
+   REQUIRE_NOTHROW(stmt.prepare("SELECT 'first' UNION ALL SELECT 'second';"));
+   REQUIRE(stmt.step());
+
+   text_view text;
+   REQUIRE_NOTHROW(text = stmt.get_view(0));
+
+   statement moved{std::move(stmt)};
+   REQUIRE(text.valid());
+   REQUIRE(std::string_view{text} == "first");
+
+   statement assigned{conn};
+   REQUIRE_NOTHROW(assigned.prepare("SELECT 1;"));
+   assigned = std::move(moved);
+   REQUIRE(text.valid());
+
+   REQUIRE(assigned.step());
+   REQUIRE(!text.valid());
+   REQUIRE_NOTHROW(text = assigned.get_view(0));
+   REQUIRE(std::string_view{text} == "second");
+}
+
+TEST_CASE("Typed row ranges should decode all rows", "[statement][rows]") {
+   connection conn;
+   REQUIRE_NOTHROW(conn.open(":memory:"));
+   REQUIRE_NOTHROW(statement::execute(conn, R"sql(
+CREATE TABLE test(id INTEGER, name TEXT, value DOUBLE);
+INSERT INTO test(id, name, value) VALUES (1, 'one', 1.5), (2, 'two', NULL), (3, 'three', 3.5);
+)sql"));
+
+   statement stmt{conn};
+   REQUIRE_NOTHROW(stmt.prepare("SELECT id, name, value FROM test ORDER BY id;"));
+
+   SECTION("range-based for") {
+      std::vector<int> ids;
+      std::vector<std::string> names;
+      std::vector<std::optional<double>> values;
+
+      for (const auto &[id, name, value] : stmt.rows<int, std::string_view, std::optional<double>>()) {
+         ids.push_back(id);
+         names.emplace_back(name);
+         values.push_back(value);
+      }
+
+      REQUIRE(ids == std::vector<int>{1, 2, 3});
+      REQUIRE(names == std::vector<std::string>{"one", "two", "three"});
+      REQUIRE(values == std::vector<std::optional<double>>{1.5, std::nullopt, 3.5});
+   }
+
+   SECTION("algorithms") {
+      auto range = stmt.rows<std::int64_t, std::string>();
+      auto it = std::find_if(range.begin(), range.end(), [](const auto &row) { return std::get<1>(row) == "two"; });
+      REQUIRE(it != range.end());
+      REQUIRE(std::get<0>(*it) == 2);
+   }
+
+   SECTION("errors should stop the iteration") {
+      std::error_code ec;
+      int count = 0;
+
+      // The name column is not a 4-byte blob
+      for (const auto &row : stmt.rows<int, std::array<std::uint8_t, 4>>(ec)) {
+         (void)row;
+         ++count;
+      }
+
+      REQUIRE(count == 0);
+      REQUIRE(ec == std::errc::invalid_argument);
+
+      REQUIRE_NOTHROW(stmt.reset());
+      REQUIRE_THROWS_AS((stmt.rows<int, std::array<std::uint8_t, 4>>().begin()), std::system_error);
+   }
+}
+
+TEST_CASE("Parameter packs should be bound positionally", "[statement][bind]") {
+   connection conn;
+   REQUIRE_NOTHROW(conn.open(":memory:"));
+   REQUIRE_NOTHROW(statement::execute(conn, "CREATE TABLE test(id INTEGER, name TEXT, value DOUBLE, data BLOB);"));
+
+   statement insert{conn};
+   REQUIRE_NOTHROW(insert.prepare("INSERT INTO test(id, name, value, data) VALUES (?, ?, ?, ?);"));
+
+   const std::array<std::uint8_t, 2> data{1, 2};
+   const std::optional<double> no_value{};
+
+   REQUIRE_NOTHROW(insert.bind_all(1, std::string_view{"one"}, 1.5, data));
+   REQUIRE_NOTHROW(insert.execute());
+
+   REQUIRE(insert.execute_with(2, std::string{"two"}, no_value, data) == 1);
+
+   std::error_code ec;
+   REQUIRE(insert.execute_with(ec, 3, std::string_view{"three"}, std::optional<double>{3.5}, data) == 1);
+   REQUIRE(!ec);
+
+   // Too many values
+   insert.reset();
+   insert.bind_all(ec, 4, std::string_view{"four"}, 4.5, data, 5);
+   REQUIRE(ec == errors::condition::range);
+
+   statement select{conn};
+   REQUIRE_NOTHROW(select.prepare("SELECT id, name, value, data FROM test ORDER BY id;"));
+
+   std::vector<std::tuple<int, std::string, std::optional<double>, std::vector<std::uint8_t>>> rows;
+   for (const auto &row : select.rows<int, std::string, std::optional<double>, std::vector<std::uint8_t>>()) {
+      rows.push_back(row);
+   }
+
+   REQUIRE(rows.size() == 3);
+   REQUIRE(rows[0] == std::make_tuple(1, std::string{"one"}, std::optional<double>{1.5}, std::vector<std::uint8_t>{1, 2}));
+   REQUIRE(rows[1] == std::make_tuple(2, std::string{"two"}, std::optional<double>{}, std::vector<std::uint8_t>{1, 2}));
+   REQUIRE(std::get<1>(rows[2]) == "three");
+}
+
+TEST_CASE("Mapped structures should be bound and read as a whole", "[statement][row_traits]") {
+   static_assert(is_mapped_row_v<mapped_entry>);
+   static_assert(!is_mapped_row_v<int>);
+   static_assert(mapped_column_count_v<mapped_entry> == 3);
+
+   connection conn;
+   REQUIRE_NOTHROW(conn.open(":memory:"));
+   REQUIRE_NOTHROW(statement::execute(conn, "CREATE TABLE test(id INTEGER, name TEXT, value DOUBLE);"));
+
+   statement insert{conn};
+   REQUIRE_NOTHROW(insert.prepare("INSERT INTO test(id, name, value) VALUES (?, ?, ?);"));
+
+   REQUIRE_NOTHROW(insert.bind_row(mapped_entry{1, "one", 1.5}));
+   REQUIRE_NOTHROW(insert.execute());
+
+   std::error_code ec;
+   insert.reset();
+   insert.bind_row(mapped_entry{2, std::nullopt, 2.5}, ec);
+   REQUIRE(!ec);
+   REQUIRE_NOTHROW(insert.execute());
+
+   statement select{conn};
+   REQUIRE_NOTHROW(select.prepare("SELECT id, name, value FROM test ORDER BY id;"));
+
+   mapped_entry e;
+   REQUIRE(select.step());
+   REQUIRE_NOTHROW(select.get_row(e));
+   REQUIRE(e.id == 1);
+   REQUIRE(e.name == "one");
+   REQUIRE(e.value == 1.5);
+
+   REQUIRE(select.step());
+   select.get_row(e, ec);
+   REQUIRE(!ec);
+   REQUIRE(e.id == 2);
+   REQUIRE(!e.name);
+   REQUIRE(e.value == 2.5);
+}
+
+TEST_CASE("Columns should be accessible by name", "[statement][get]") {
+   connection conn;
+   REQUIRE_NOTHROW(conn.open(":memory:"));
+   REQUIRE_NOTHROW(statement::execute(conn, R"sql(
+CREATE TABLE test(id INTEGER, name TEXT);
+INSERT INTO test(id, name) VALUES (1, 'one');
+)sql"));
+
+   statement stmt{conn};
+   REQUIRE_NOTHROW(stmt.prepare("SELECT * FROM test;"));
+   REQUIRE(stmt.find_column("id") == 0);
+   REQUIRE(stmt.find_column("name") == 1);
+   REQUIRE(!stmt.find_column("missing"));
+
+   REQUIRE(stmt.step());
+
+   int id;
+   std::string name;
+   REQUIRE_NOTHROW(stmt.get("name", name));
+   REQUIRE_NOTHROW(stmt.get("id", id));
+   REQUIRE(id == 1);
+   REQUIRE(name == "one");
+
+   std::error_code ec;
+   stmt.get("missing", id, ec);
+   REQUIRE(ec == std::errc::invalid_argument);
+   REQUIRE_THROWS_AS(stmt.get("missing", id), std::system_error);
+
+   SECTION("Schema changes should be picked up") {
+      REQUIRE_NOTHROW(stmt.reset());
+      REQUIRE_NOTHROW(statement::execute(conn, "ALTER TABLE test ADD COLUMN extra INTEGER DEFAULT 42;"));
+      REQUIRE(stmt.step());
+
+      int extra;
+      REQUIRE_NOTHROW(stmt.get("extra", extra));
+      REQUIRE(extra == 42);
+   }
+
+   SECTION("Re-preparing should rebuild the map") {
+      REQUIRE_NOTHROW(stmt.prepare("SELECT name AS renamed, id FROM test;"));
+      REQUIRE(stmt.find_column("renamed") == 0);
+      REQUIRE(stmt.find_column("id") == 1);
+      REQUIRE(!stmt.find_column("name"));
+   }
+
+   SECTION("Many columns should be supported") {
+      REQUIRE_NOTHROW(stmt.prepare(
+          "SELECT 0 AS c0, 1 AS c1, 2 AS c2, 3 AS c3, 4 AS c4, 5 AS c5, 6 AS c6, 7 AS c7, 8 AS c8, 9 AS c9, 1 AS c0;"));
+      for (int i = 0; i < 10; ++i) {
+         REQUIRE(stmt.find_column("c" + std::to_string(i)) == i);
+      }
+   }
+}
+
+TEST_CASE("Parameter handles should bind without name lookups", "[statement][bind]") {
+   connection conn;
+   REQUIRE_NOTHROW(conn.open(":memory:"));
+   REQUIRE_NOTHROW(statement::execute(conn, "CREATE TABLE test(id INTEGER, name TEXT);"));
+
+   statement insert{conn};
+   REQUIRE_NOTHROW(insert.prepare("INSERT INTO test(id, name) VALUES (:pid, :pname);"));
+
+   auto id = insert.param(":pid");
+   auto name = insert.param(":pname");
+   REQUIRE(id);
+   REQUIRE(name);
+   REQUIRE(id.index == 1);
+   REQUIRE(name.index == 2);
+
+   REQUIRE_THROWS_AS(insert.param(":pmissing"), std::system_error);
+
+   std::error_code ec;
+   auto missing = insert.param(":pmissing", ec);
+   REQUIRE(ec == std::errc::invalid_argument);
+   REQUIRE(!missing);
+
+   for (int i = 0; i < 3; ++i) {
+      REQUIRE_NOTHROW(insert.reset());
+      REQUIRE_NOTHROW(insert.bind(id, i));
+      if (i == 1) {
+         REQUIRE_NOTHROW(insert.bind_null(name));
+      } else {
+         REQUIRE_NOTHROW(insert.bind(name, std::string{"name"}));
+      }
+      REQUIRE_NOTHROW(insert.execute());
+   }
+
+   statement count{conn};
+   REQUIRE_NOTHROW(count.prepare("SELECT COUNT(*), COUNT(name) FROM test;"));
+   REQUIRE(count.step());
+
+   int total, names;
+   REQUIRE_NOTHROW(count.get(0, total));
+   REQUIRE_NOTHROW(count.get(1, names));
+   REQUIRE(total == 3);
+   REQUIRE(names == 2);
+
+   SECTION("Statements with many parameters should be supported") {
+      std::string sql = "SELECT ";
+      for (int i = 0; i < 20; ++i) {
+         sql += (i ? ", :p" : ":p") + std::to_string(i);
+      }
+      sql += ", ?;";
+
+      statement many{conn};
+      REQUIRE_NOTHROW(many.prepare(sql));
+      for (int i = 0; i < 20; ++i) {
+         REQUIRE(many.param(":p" + std::to_string(i)).index == i + 1);
+         REQUIRE_NOTHROW(many.bind(":p" + std::to_string(i), i));
+      }
+
+      // Re-preparing should invalidate the previous names
+      REQUIRE_NOTHROW(many.prepare("SELECT :pother;"));
+      REQUIRE(!many.param(":p0", ec));
+      REQUIRE(many.param(":pother").index == 1);
+   }
+}
+
+TEST_CASE("Unchecked getters should read numeric values", "[statement][get]") {
+   connection conn;
+   REQUIRE_NOTHROW(conn.open(":memory:"));
+
+   statement stmt{conn};
+   REQUIRE_NOTHROW(stmt.prepare("SELECT 0, 42, -7, 0.0, 2.5, NULL, 'text', 5000000000;"));
+   REQUIRE(stmt.step());
+
+   REQUIRE(stmt.get_unchecked<int>(0) == 0);
+   REQUIRE(stmt.get_unchecked<int>(1) == 42);
+   REQUIRE(stmt.get_unchecked<std::int8_t>(2) == -7);
+   REQUIRE(stmt.get_unchecked<double>(3) == 0.0);
+   REQUIRE(stmt.get_unchecked<float>(4) == 2.5f);
+   REQUIRE(stmt.get_unchecked<std::int64_t>(5) == 0);
+   REQUIRE(stmt.get_unchecked<std::int64_t>(6) == 0);
+   REQUIRE(stmt.get_unchecked<std::int64_t>(7) == 5000000000);
+   REQUIRE(stmt.get_unchecked<bool>(1));
+   REQUIRE(!stmt.get_unchecked<bool>(0));
+
+   SECTION("Checked getters should still tell zeroes from errors") {
+      std::error_code ec;
+      std::int64_t value = -1;
+
+      stmt.get(0, value, ec);
+      REQUIRE(!ec);
+      REQUIRE(value == 0);
+
+      double dvalue = -1;
+      stmt.get(3, dvalue, ec);
+      REQUIRE(!ec);
+      REQUIRE(dvalue == 0.0);
+
+      stmt.get(5, value, ec);
+      REQUIRE(!ec);
+
+      stmt.get(6, value, ec);
+      REQUIRE(!ec);
+
+      stmt.get(100, value, ec);
+      REQUIRE(ec);
+   }
+
+   // Out-of-range indices are read as zero
+   REQUIRE(stmt.get_unchecked<int>(100) == 0);
+}
@@ -0,0 +1,154 @@
+/**
+ * @file   statement_cache.cpp
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sqlite-burrito/connection.h>
+#include <sqlite-burrito/statement.h>
+#include <sqlite-burrito/statement_cache.h>
+
+#include <system_error>
+
+using namespace sqlite_burrito;
+
+namespace {
+
+class statement_cache_test {
+public:
+   statement_cache_test() {
+      con_.open(":memory:");
+      statement::execute(con_, "CREATE TABLE test(value INTEGER);");
+   }
+
+protected:
+   connection con_{};
+};
+
+} // namespace
+
+TEST_CASE_METHOD(statement_cache_test, "Returned statements should be reused", "[statement_cache]") {
+   auto &cache = con_.cache();
+
+   const auto sql = "INSERT INTO test(value) VALUES (:pvalue);";
+   statement *first_ptr;
+   {
+      auto first = cache.acquire(sql);
+      first_ptr = &*first;
+      REQUIRE_NOTHROW(first->bind(":pvalue", 1));
+      REQUIRE_NOTHROW(first->execute());
+   }
+
+   auto stats = cache.stats();
+   REQUIRE(stats.hits == 0);
+   REQUIRE(stats.misses == 1);
+   REQUIRE(stats.size == 1);
+
+   {
+      auto second = cache.acquire(sql);
+      REQUIRE(&*second == first_ptr);
+
+      // The statement should be reset, and the bindings cleared
+      REQUIRE_NOTHROW(second->execute());
+
+      // A concurrently leased statement should be a new one
+      auto third = cache.acquire(sql);
+      REQUIRE(&*third != first_ptr);
+   }
+
+   stats = cache.stats();
+   REQUIRE(stats.hits == 1);
+   REQUIRE(stats.misses == 2);
+   REQUIRE(stats.size == 2);
+
+   statement count{con_};
+   count.prepare("SELECT COUNT(*) FROM test WHERE value IS NULL;");
+   REQUIRE(count.step());
+
+   int nulls;
+   REQUIRE_NOTHROW(count.get(0, nulls));
+   REQUIRE(nulls == 1);
+}
+
+TEST_CASE_METHOD(statement_cache_test, "Least recently used statements should be evicted", "[statement_cache]") {
+   statement_cache cache{con_, {2, 0}};
+
+   cache.acquire("SELECT 1;");
+   cache.acquire("SELECT 2;");
+   cache.acquire("SELECT 1;");
+   cache.acquire("SELECT 3;");
+
+   auto stats = cache.stats();
+   REQUIRE(stats.hits == 1);
+   REQUIRE(stats.misses == 3);
+   REQUIRE(stats.evictions == 1);
+   REQUIRE(stats.size == 2);
+
+   // "SELECT 2" should be gone
+   cache.acquire("SELECT 2;");
+   stats = cache.stats();
+   REQUIRE(stats.misses == 4);
+
+   SECTION("Shrinking the limits should evict immediately") {
+      cache.set_limits({0, 0});
+      stats = cache.stats();
+      REQUIRE(stats.size == 0);
+      REQUIRE(stats.bytes == 0);
+   }
+
+   SECTION("Memory limits should be respected") {
+      cache.set_limits({16, 1});
+      stats = cache.stats();
+      REQUIRE(stats.size == 0);
+   }
+}
+
+TEST_CASE_METHOD(statement_cache_test, "Invalid statements should not be cached", "[statement_cache]") {
+   auto &cache = con_.cache();
+   REQUIRE_THROWS_AS(cache.acquire("FOO BAR;"), std::system_error);
+
+   std::error_code ec;
+   auto lease = cache.acquire("FOO BAR;", ec);
+   REQUIRE(ec);
+   REQUIRE(!lease);
+   REQUIRE(cache.stats().size == 0);
+}
+
+TEST_CASE_METHOD(statement_cache_test, "Empty statements should be rejected", "[statement_cache]") {
+   auto &cache = con_.cache();
+
+   for (auto sql : {"", "  ", "-- comment"}) {
+      std::error_code ec;
+      auto lease = cache.acquire(sql, ec);
+      REQUIRE(ec == std::errc::invalid_argument);
+      REQUIRE(!lease);
+   }
+
+   REQUIRE_THROWS_AS(cache.acquire("  "), std::system_error);
+   REQUIRE(cache.stats().size == 0);
+}
+
+TEST_CASE_METHOD(statement_cache_test, "Leases should not survive re-opening the connection", "[statement_cache]") {
+   REQUIRE_NOTHROW(statement::execute(con_, "INSERT INTO test(value) VALUES (42);"));
+
+   auto &cache = con_.cache();
+   {
+      auto lease = cache.acquire("SELECT COUNT(*) FROM test;");
+      REQUIRE(lease->step());
+
+      // The lease is returned after the connection was re-opened
+      REQUIRE_NOTHROW(con_.open(":memory:"));
+   }
+
+   REQUIRE(cache.stats().size == 0);
+   REQUIRE_NOTHROW(statement::execute(con_, "CREATE TABLE test(value INTEGER);"));
+
+   auto lease = cache.acquire("SELECT COUNT(*) FROM test;");
+   REQUIRE(cache.stats().hits == 0);
+   REQUIRE(::sqlite3_db_handle(&lease->native_handle()) == &con_.native_handle());
+
+   int count = -1;
+   REQUIRE(lease->step());
+   lease->get(0, count);
+   REQUIRE(count == 0);
+}
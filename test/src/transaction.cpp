@@ -7,6 +7,7 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include <sqlite-burrito/connection.h>
+#include <sqlite-burrito/errors/sqlite.h>
 #include <sqlite-burrito/statement.h>
 #include <sqlite-burrito/transaction.h>
 
@@ -117,3 +118,130 @@ TEST_CASE_METHOD(transaction_test, "Changes after rolling back should be propaga
 
    REQUIRE(count_entries() == 2);
 }
+
+TEST_CASE_METHOD(transaction_test, "Control statements should be reusable", "[transaction]") {
+   using behavior = transaction::behavior;
+
+   for (int i = 0; i < 10; ++i) {
+      for (auto b : {behavior::deferred, behavior::immediate, behavior::exclusive}) {
+         transaction trans{con_, b};
+         REQUIRE_NOTHROW(add_entry("test"));
+         if (i % 2) {
+            REQUIRE_NOTHROW(trans.commit());
+         } else {
+            REQUIRE_NOTHROW(trans.rollback());
+         }
+      }
+   }
+
+   REQUIRE(count_entries() == 15);
+}
+
+TEST_CASE_METHOD(transaction_test, "Nested transactions should use savepoints", "[transaction]") {
+   REQUIRE(count_entries() == 0);
+
+   SECTION("Committing both should propagate all changes") {
+      transaction outer{con_, transaction::behavior::immediate};
+      REQUIRE(!outer.is_nested());
+      REQUIRE_NOTHROW(add_entry("outer"));
+      {
+         transaction inner{con_};
+         REQUIRE(inner.is_nested());
+         REQUIRE_NOTHROW(add_entry("inner"));
+         REQUIRE_NOTHROW(inner.commit());
+      }
+      REQUIRE_NOTHROW(outer.commit());
+      REQUIRE(count_entries() == 2);
+   }
+
+   SECTION("Rolling back the inner one should only discard its changes") {
+      transaction outer{con_};
+      REQUIRE_NOTHROW(add_entry("outer"));
+      {
+         transaction inner{con_};
+         REQUIRE_NOTHROW(add_entry("inner"));
+         REQUIRE_NOTHROW(inner.rollback());
+      }
+      {
+         // Auto-rollback on scope exit
+         transaction inner{con_};
+         REQUIRE_NOTHROW(add_entry("inner"));
+      }
+      REQUIRE(count_entries() == 1);
+      REQUIRE_NOTHROW(outer.commit());
+      REQUIRE(count_entries() == 1);
+   }
+
+   SECTION("Rolling back the outer one should discard everything") {
+      {
+         transaction outer{con_};
+         REQUIRE_NOTHROW(add_entry("outer"));
+
+         transaction inner{con_};
+         REQUIRE_NOTHROW(add_entry("inner"));
+         REQUIRE_NOTHROW(inner.commit());
+      }
+      REQUIRE(count_entries() == 0);
+   }
+
+   SECTION("Multiple nesting levels should be supported") {
+      transaction outer{con_};
+      for (int i = 0; i < 3; ++i) {
+         transaction first{con_};
+         transaction second{con_};
+         transaction third{con_};
+         REQUIRE_NOTHROW(add_entry("nested"));
+         REQUIRE_NOTHROW(third.commit());
+         REQUIRE_NOTHROW(second.commit());
+         if (i != 1) {
+            REQUIRE_NOTHROW(first.commit());
+         }
+      }
+      REQUIRE_NOTHROW(outer.commit());
+      REQUIRE(count_entries() == 2);
+
+      // A new outermost transaction should not be treated as nested
+      transaction next{con_};
+      REQUIRE(!next.is_nested());
+   }
+}
+
+TEST_CASE_METHOD(transaction_test, "Failed commits should keep the savepoints", "[transaction]") {
+   REQUIRE_NOTHROW(statement::execute(con_, R"sql(
+PRAGMA foreign_keys = ON;
+CREATE TABLE parent(id INTEGER PRIMARY KEY);
+CREATE TABLE child(parent_id INTEGER REFERENCES parent(id) DEFERRABLE INITIALLY DEFERRED);
+)sql"));
+
+   transaction outer{con_};
+   REQUIRE_NOTHROW(add_entry("outer"));
+
+   transaction inner{con_};
+   REQUIRE_NOTHROW(statement::execute(con_, "INSERT INTO child(parent_id) VALUES (1);"));
+
+   // Deferred constraint violation: the commit fails, and the transaction (with the savepoint) stays open
+   std::error_code ec;
+   outer.commit(ec);
+   REQUIRE(ec == errors::condition::constraint);
+
+   {
+      transaction next{con_};
+      REQUIRE(next.is_nested());
+      REQUIRE_NOTHROW(add_entry("next"));
+
+      // Should discard everything since the inner savepoint, including the next one
+      REQUIRE_NOTHROW(inner.rollback());
+
+      statement children{con_};
+      REQUIRE_NOTHROW(children.prepare("SELECT COUNT(*) FROM child;"));
+      REQUIRE(children.step());
+
+      int num_children = -1;
+      REQUIRE_NOTHROW(children.get(0, num_children));
+      REQUIRE(num_children == 0);
+      REQUIRE(count_entries() == 1);
+   }
+
+   REQUIRE_NOTHROW(outer.commit());
+   REQUIRE(count_entries() == 1);
+}